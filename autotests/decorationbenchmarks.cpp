@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include <QTest>
+#include <QHoverEvent>
+#include "../src/decorationbuttongroup.h"
+#include "../src/decorationsettings.h"
+#include "../src/decorationshadow.h"
+#include "mockbridge.h"
+#include "mockbutton.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+#include "mocksettings.h"
+
+#include <memory>
+#include <vector>
+
+class DecorationBenchmarks : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkHoverMove_data();
+    void benchmarkHoverMove();
+    void benchmarkSectionSweep();
+    void benchmarkGroupLayout_data();
+    void benchmarkGroupLayout();
+    void benchmarkShadowGeometry();
+};
+
+namespace {
+// a decoration of 500x520 with a titlebar of 20 and borders of 1
+struct DecorationFixture
+{
+    DecorationFixture()
+        : settings(QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge))
+        , decoration(&bridge)
+    {
+        decoration.setSettings(settings);
+        MockClient *client = bridge.lastCreatedClient();
+        client->setWidth(498);
+        client->setHeight(498);
+        decoration.setBorders(QMargins(1, 21, 1, 1));
+        decoration.setTitleBar(QRect(1, 1, 498, 20));
+    }
+    MockBridge bridge;
+    QSharedPointer<KDecoration2::DecorationSettings> settings;
+    MockDecoration decoration;
+};
+}
+
+void DecorationBenchmarks::benchmarkHoverMove_data()
+{
+    QTest::addColumn<int>("buttonCount");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("6") << 6;
+    QTest::newRow("24") << 24;
+}
+
+void DecorationBenchmarks::benchmarkHoverMove()
+{
+    DecorationFixture fixture;
+    QFETCH(int, buttonCount);
+    std::vector<std::unique_ptr<MockButton>> buttons;
+    for (int i = 0; i < buttonCount; ++i) {
+        buttons.emplace_back(new MockButton(KDecoration2::DecorationButtonType::Custom, &fixture.decoration));
+        buttons.back()->setGeometry(QRectF(1 + i * 20, 1, 20, 20));
+    }
+
+    // move the mouse along the titlebar, entering and leaving all buttons
+    QVector<QHoverEvent*> events;
+    QPointF oldPos(0, 10);
+    for (int x = 0; x < 500; x += 3) {
+        const QPointF pos(x, 10);
+        events << new QHoverEvent(QEvent::HoverMove, pos, oldPos);
+        oldPos = pos;
+    }
+    QBENCHMARK {
+        for (QHoverEvent *event : qAsConst(events)) {
+            QCoreApplication::sendEvent(&fixture.decoration, event);
+        }
+    }
+    qDeleteAll(events);
+}
+
+void DecorationBenchmarks::benchmarkSectionSweep()
+{
+    DecorationFixture fixture;
+    QVector<QHoverEvent*> events;
+    QPointF oldPos(-1, -1);
+    for (int y = 0; y < 520; y += 4) {
+        for (int x = 0; x < 500; x += 4) {
+            const QPointF pos(x, y);
+            events << new QHoverEvent(QEvent::HoverMove, pos, oldPos);
+            oldPos = pos;
+        }
+    }
+    QBENCHMARK {
+        for (QHoverEvent *event : qAsConst(events)) {
+            QCoreApplication::sendEvent(&fixture.decoration, event);
+        }
+    }
+    qDeleteAll(events);
+}
+
+void DecorationBenchmarks::benchmarkGroupLayout_data()
+{
+    QTest::addColumn<int>("buttonCount");
+
+    QTest::newRow("3") << 3;
+    QTest::newRow("6") << 6;
+    QTest::newRow("12") << 12;
+}
+
+void DecorationBenchmarks::benchmarkGroupLayout()
+{
+    DecorationFixture fixture;
+    QFETCH(int, buttonCount);
+    KDecoration2::DecorationButtonGroup group(&fixture.decoration);
+    group.setSpacing(2);
+    QVector<MockButton*> buttons;
+    for (int i = 0; i < buttonCount; ++i) {
+        auto button = new MockButton(KDecoration2::DecorationButtonType::Custom, &fixture.decoration, &group);
+        button->setGeometry(QRectF(0, 0, 20, 20));
+        group.addButton(QPointer<KDecoration2::DecorationButton>(button));
+        buttons << button;
+    }
+
+    // churn as caused by state changes of the client: buttons get hidden and shown,
+    // resized and the group gets moved
+    QBENCHMARK {
+        for (MockButton *button : qAsConst(buttons)) {
+            button->setVisible(false);
+        }
+        for (MockButton *button : qAsConst(buttons)) {
+            button->setVisible(true);
+        }
+        for (MockButton *button : qAsConst(buttons)) {
+            button->setGeometry(QRectF(button->geometry().topLeft(), QSizeF(24, 24)));
+        }
+        for (MockButton *button : qAsConst(buttons)) {
+            button->setGeometry(QRectF(button->geometry().topLeft(), QSizeF(20, 20)));
+        }
+        group.setPos(QPointF(5, 5));
+        group.setPos(QPointF(0, 0));
+    }
+}
+
+void DecorationBenchmarks::benchmarkShadowGeometry()
+{
+    KDecoration2::DecorationShadow shadow;
+    QImage image(QSize(128, 128), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    shadow.setShadow(image);
+    shadow.setInnerShadowRect(QRect(32, 32, 64, 64));
+    shadow.setPadding(QMargins(24, 24, 24, 24));
+
+    QRect bounds;
+    QBENCHMARK {
+        bounds |= shadow.topLeftGeometry();
+        bounds |= shadow.topGeometry();
+        bounds |= shadow.topRightGeometry();
+        bounds |= shadow.rightGeometry();
+        bounds |= shadow.bottomRightGeometry();
+        bounds |= shadow.bottomGeometry();
+        bounds |= shadow.bottomLeftGeometry();
+        bounds |= shadow.leftGeometry();
+    }
+    QCOMPARE(bounds, image.rect());
+}
+
+QTEST_MAIN(DecorationBenchmarks)
+#include "decorationbenchmarks.moc"
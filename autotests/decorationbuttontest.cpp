@@ -4,9 +4,12 @@
  * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
  */
 #include <QTest>
+#include <QPainter>
+#include <QRegularExpression>
 #include <QSignalSpy>
 #include <QStyleHints>
 #include "../src/decoratedclient.h"
+#include "../src/decorationbuttongroup.h"
 #include "../src/decorationsettings.h"
 #include "mockdecoration.h"
 #include "mockbridge.h"
@@ -16,6 +19,22 @@
 
 Q_DECLARE_METATYPE(Qt::MouseButton)
 
+class PaintCountingButton : public KDecoration2::DecorationButton
+{
+public:
+    PaintCountingButton(const QPointer<KDecoration2::Decoration> &decoration)
+        : DecorationButton(KDecoration2::DecorationButtonType::Custom, decoration)
+    {
+    }
+    void paint(QPainter *painter, const QRect &repaintRegion) override
+    {
+        Q_UNUSED(repaintRegion)
+        painter->fillRect(geometry(), isHovered() ? Qt::red : Qt::blue);
+        paintCount++;
+    }
+    int paintCount = 0;
+};
+
 class DecorationButtonTest : public QObject
 {
     Q_OBJECT
@@ -48,6 +67,10 @@ private Q_SLOTS:
     void testApplicationMenu();
     void testContains_data();
     void testContains();
+    void testPaintCache();
+    void testLayoutTransaction();
+    void testNestedLayout();
+    void testButtonListChanged();
 };
 
 void DecorationButtonTest::testButton()
@@ -1361,5 +1384,226 @@ void DecorationButtonTest::testContains()
     QTEST(button.contains(pos), "contains");
 }
 
+void DecorationButtonTest::testPaintCache()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration mockDecoration(&bridge);
+    mockDecoration.setSettings(decoSettings);
+    KDecoration2::DecorationButtonGroup group(&mockDecoration);
+    PaintCountingButton button(&mockDecoration);
+    button.setGeometry(QRectF(0, 0, 10, 10));
+    group.addButton(&button);
+    QCOMPARE(button.isPaintCacheEnabled(), false);
+
+    QImage image(20, 20, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    group.paint(&painter, image.rect());
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 2);
+
+    button.setPaintCacheEnabled(true);
+    QCOMPARE(button.isPaintCacheEnabled(), true);
+    group.paint(&painter, image.rect());
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 3);
+    QCOMPARE(image.pixelColor(5, 5), QColor(Qt::blue));
+
+    // a new state gets rendered once
+    QHoverEvent enterEvent(QEvent::HoverEnter, QPoint(5, 5), QPoint());
+    button.event(&enterEvent);
+    QCOMPARE(button.isHovered(), true);
+    group.paint(&painter, image.rect());
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 4);
+    QCOMPARE(image.pixelColor(5, 5), QColor(Qt::red));
+
+    // going back to a known state uses the cache
+    QHoverEvent leaveEvent(QEvent::HoverLeave, QPoint(50, 50), QPoint(5, 5));
+    button.event(&leaveEvent);
+    QCOMPARE(button.isHovered(), false);
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 4);
+    QCOMPARE(image.pixelColor(5, 5), QColor(Qt::blue));
+
+    // areas not covering the button don't paint it at all
+    button.invalidatePaintCache();
+    group.paint(&painter, QRect(15, 15, 5, 5));
+    QCOMPARE(button.paintCount, 4);
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 5);
+
+    // changes of the settings the symbols are commonly sized with drop the cache
+    emit decoSettings->fontChanged(decoSettings->font());
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 6);
+    emit decoSettings->spacingChanged();
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 7);
+    emit decoSettings->reconfigured();
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 8);
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 8);
+
+    button.setPaintCacheEnabled(false);
+    group.paint(&painter, image.rect());
+    QCOMPARE(button.paintCount, 9);
+}
+
+void DecorationButtonTest::testLayoutTransaction()
+{
+    MockBridge bridge;
+    MockDecoration mockDecoration(&bridge);
+    KDecoration2::DecorationButtonGroup group(&mockDecoration);
+    QSignalSpy groupGeometrySpy(&group, &KDecoration2::DecorationButtonGroup::geometryChanged);
+    QVERIFY(groupGeometrySpy.isValid());
+
+    QVector<MockButton*> buttons;
+    QVector<QSignalSpy*> geometrySpies;
+    {
+        KDecoration2::DecorationButtonGroup::LayoutTransaction transaction(&group);
+        for (int i = 0; i < 4; ++i) {
+            auto button = new MockButton(KDecoration2::DecorationButtonType::Custom, &mockDecoration, &group);
+            button->setGeometry(QRectF(0, 0, 10, 10));
+            geometrySpies << new QSignalSpy(button, &KDecoration2::DecorationButton::geometryChanged);
+            group.addButton(button);
+            buttons << button;
+        }
+        // nested transactions don't trigger a layout
+        group.beginLayoutTransaction();
+        group.setSpacing(1);
+        group.commitLayoutTransaction();
+        QCOMPARE(groupGeometrySpy.count(), 0);
+        QCOMPARE(buttons.last()->geometry(), QRectF(0, 0, 10, 10));
+    }
+    // committing the transaction positions all buttons once
+    QCOMPARE(groupGeometrySpy.count(), 1);
+    QCOMPARE(group.geometry(), QRectF(0, 0, 43, 10));
+    for (int i = 0; i < buttons.count(); ++i) {
+        QCOMPARE(buttons.at(i)->geometry(), QRectF(i * 11, 0, 10, 10));
+        // the first button is already at the right position
+        QCOMPARE(geometrySpies.at(i)->count(), i == 0 ? 0 : 1);
+    }
+
+    // resizing all buttons in a transaction
+    group.beginLayoutTransaction();
+    for (MockButton *button : qAsConst(buttons)) {
+        button->setGeometry(QRectF(button->geometry().topLeft(), QSizeF(20, 20)));
+    }
+    QCOMPARE(groupGeometrySpy.count(), 1);
+    group.commitLayoutTransaction();
+    QCOMPARE(groupGeometrySpy.count(), 2);
+    QCOMPARE(group.geometry(), QRectF(0, 0, 83, 20));
+    for (int i = 0; i < buttons.count(); ++i) {
+        QCOMPARE(buttons.at(i)->geometry(), QRectF(i * 21, 0, 20, 20));
+    }
+    qDeleteAll(geometrySpies);
+}
+
+void DecorationButtonTest::testNestedLayout()
+{
+    MockBridge bridge;
+    MockDecoration mockDecoration(&bridge);
+    KDecoration2::DecorationButtonGroup leftGroup(&mockDecoration);
+    KDecoration2::DecorationButtonGroup rightGroup(&mockDecoration);
+    rightGroup.setPos(QPointF(100, 0));
+
+    MockButton left1(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    left1.setGeometry(QRectF(0, 0, 10, 10));
+    MockButton left2(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    left2.setGeometry(QRectF(0, 0, 10, 10));
+    MockButton right1(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    right1.setGeometry(QRectF(0, 0, 10, 10));
+    MockButton right2(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    right2.setGeometry(QRectF(0, 0, 10, 10));
+    leftGroup.addButton(&left1);
+    leftGroup.addButton(&left2);
+    rightGroup.addButton(&right1);
+    rightGroup.addButton(&right2);
+    QCOMPARE(left2.geometry(), QRectF(10, 0, 10, 10));
+    QCOMPARE(right2.geometry(), QRectF(110, 0, 10, 10));
+
+    // a button growing when getting positioned triggers a follow-up layout pass
+    // and a change of another group during the layout is not lost
+    QMetaObject::Connection connection = connect(&left1, &KDecoration2::DecorationButton::geometryChanged, this,
+        [&left1, &right1] {
+            if (left1.size().width() < 20) {
+                left1.setGeometry(QRectF(left1.geometry().topLeft(), QSizeF(20, 10)));
+                right1.setGeometry(QRectF(right1.geometry().topLeft(), QSizeF(20, 10)));
+            }
+        }
+    );
+    leftGroup.setPos(QPointF(5, 0));
+    disconnect(connection);
+    QCOMPARE(left1.geometry(), QRectF(5, 0, 20, 10));
+    QCOMPARE(left2.geometry(), QRectF(25, 0, 10, 10));
+    QCOMPARE(leftGroup.geometry(), QRectF(5, 0, 30, 10));
+    QCOMPARE(right1.geometry(), QRectF(100, 0, 20, 10));
+    QCOMPARE(right2.geometry(), QRectF(120, 0, 10, 10));
+    QCOMPARE(rightGroup.geometry(), QRectF(100, 0, 30, 10));
+
+    // buttons which never settle end the layout with a warning
+    connection = connect(&left2, &KDecoration2::DecorationButton::geometryChanged, this,
+        [&left1] {
+            left1.setGeometry(QRectF(left1.geometry().topLeft(), left1.size() + QSizeF(1, 0)));
+        }
+    );
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("still changed after 8 layout passes")));
+    leftGroup.setPos(QPointF(0, 0));
+    disconnect(connection);
+    QCOMPARE(left1.geometry(), QRectF(0, 0, 28, 10));
+}
+
+void DecorationButtonTest::testButtonListChanged()
+{
+    using KDecoration2::DecorationButtonType;
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockSettings *settings = bridge.lastCreatedSettings();
+    QVERIFY(settings);
+    settings->setDecorationButtonsLeft({DecorationButtonType::Menu, DecorationButtonType::Minimize, DecorationButtonType::Close});
+    MockDecoration mockDecoration(&bridge);
+    mockDecoration.setSettings(decoSettings);
+
+    int created = 0;
+    KDecoration2::DecorationButtonGroup group(KDecoration2::DecorationButtonGroup::Position::Left, &mockDecoration,
+        [&created](DecorationButtonType type, KDecoration2::Decoration *decoration, QObject *parent) {
+            created++;
+            auto button = new MockButton(type, decoration, parent);
+            button->setGeometry(QRectF(0, 0, 10, 10));
+            return button;
+        }
+    );
+    QCOMPARE(created, 3);
+    const auto initialButtons = group.buttons();
+    QCOMPARE(initialButtons.count(), 3);
+    QCOMPARE(initialButtons.at(0)->type(), DecorationButtonType::Menu);
+    QCOMPARE(initialButtons.at(1)->type(), DecorationButtonType::Minimize);
+    QCOMPARE(initialButtons.at(2)->type(), DecorationButtonType::Close);
+    QPointer<KDecoration2::DecorationButton> minimize = initialButtons.at(1);
+
+    // reordering reuses the existing buttons
+    settings->setDecorationButtonsLeft({DecorationButtonType::Close, DecorationButtonType::Menu, DecorationButtonType::Minimize});
+    QCOMPARE(created, 3);
+    auto buttons = group.buttons();
+    QCOMPARE(buttons, (QVector<QPointer<KDecoration2::DecorationButton>>{initialButtons.at(2), initialButtons.at(0), initialButtons.at(1)}));
+    QCOMPARE(buttons.at(0)->geometry(), QRectF(0, 0, 10, 10));
+    QCOMPARE(buttons.at(1)->geometry(), QRectF(10, 0, 10, 10));
+    QCOMPARE(buttons.at(2)->geometry(), QRectF(20, 0, 10, 10));
+
+    // only the delta gets created and destroyed
+    settings->setDecorationButtonsLeft({DecorationButtonType::Close, DecorationButtonType::Maximize, DecorationButtonType::Menu});
+    QCOMPARE(created, 4);
+    QVERIFY(minimize.isNull());
+    buttons = group.buttons();
+    QCOMPARE(buttons.count(), 3);
+    QCOMPARE(buttons.at(0), initialButtons.at(2));
+    QCOMPARE(buttons.at(1)->type(), DecorationButtonType::Maximize);
+    QCOMPARE(buttons.at(2), initialButtons.at(0));
+    QCOMPARE(buttons.at(1)->geometry(), QRectF(10, 0, 10, 10));
+    QCOMPARE(buttons.at(2)->geometry(), QRectF(20, 0, 10, 10));
+}
+
 QTEST_MAIN(DecorationButtonTest)
 #include "decorationbuttontest.moc"
@@ -0,0 +1,320 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationinputtrace.h"
+#include "../src/decoratedclient.h"
+#include "../src/decoration.h"
+#include "../src/decorationbutton.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QHoverEvent>
+#include <QIODevice>
+#include <QMouseEvent>
+#include <QPointer>
+#include <QWheelEvent>
+
+#include <limits>
+
+namespace KDecoration2
+{
+
+namespace {
+// "KDIT"
+const quint32 s_magic = 0x4b444954;
+const quint32 s_version = 1;
+
+// compact tags of the recorded events
+enum class Record : quint8 {
+    HoverEnter,
+    HoverLeave,
+    HoverMove,
+    MouseButtonPress,
+    MouseButtonRelease,
+    MouseMove,
+    Wheel
+};
+
+bool recordForType(QEvent::Type type, Record *record)
+{
+    switch (type) {
+    case QEvent::HoverEnter:
+        *record = Record::HoverEnter;
+        return true;
+    case QEvent::HoverLeave:
+        *record = Record::HoverLeave;
+        return true;
+    case QEvent::HoverMove:
+        *record = Record::HoverMove;
+        return true;
+    case QEvent::MouseButtonPress:
+        *record = Record::MouseButtonPress;
+        return true;
+    case QEvent::MouseButtonRelease:
+        *record = Record::MouseButtonRelease;
+        return true;
+    case QEvent::MouseMove:
+        *record = Record::MouseMove;
+        return true;
+    case QEvent::Wheel:
+        *record = Record::Wheel;
+        return true;
+    default:
+        return false;
+    }
+}
+
+QEvent::Type typeForRecord(Record record)
+{
+    switch (record) {
+    case Record::HoverEnter:
+        return QEvent::HoverEnter;
+    case Record::HoverLeave:
+        return QEvent::HoverLeave;
+    case Record::HoverMove:
+        return QEvent::HoverMove;
+    case Record::MouseButtonPress:
+        return QEvent::MouseButtonPress;
+    case Record::MouseButtonRelease:
+        return QEvent::MouseButtonRelease;
+    case Record::MouseMove:
+        return QEvent::MouseMove;
+    case Record::Wheel:
+        return QEvent::Wheel;
+    }
+    return QEvent::None;
+}
+
+void setupStream(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+}
+}
+
+class Q_DECL_HIDDEN DecorationInputRecorder::Private
+{
+public:
+    QPointer<Decoration> decoration;
+    QDataStream stream;
+    QElapsedTimer timer;
+    qint64 lastEvent = 0;
+    int eventCount = 0;
+};
+
+DecorationInputRecorder::DecorationInputRecorder(Decoration *decoration, QIODevice *device, QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+    d->decoration = decoration;
+    d->stream.setDevice(device);
+    setupStream(d->stream);
+
+    // the buttons are children of the Decoration or of its DecorationButtonGroups
+    const QList<DecorationButton*> buttons = decoration->findChildren<DecorationButton*>();
+    QVector<QRectF> buttonGeometries;
+    buttonGeometries.reserve(buttons.count());
+    for (DecorationButton *button : buttons) {
+        buttonGeometries << button->geometry();
+    }
+    d->stream << s_magic << s_version
+              << decoration->client().toStrongRef()->size()
+              << decoration->borders()
+              << decoration->titleBar()
+              << buttonGeometries;
+
+    decoration->installEventFilter(this);
+    d->timer.start();
+}
+
+DecorationInputRecorder::~DecorationInputRecorder()
+{
+    if (d->decoration) {
+        d->decoration->removeEventFilter(this);
+    }
+}
+
+int DecorationInputRecorder::eventCount() const
+{
+    return d->eventCount;
+}
+
+bool DecorationInputRecorder::eventFilter(QObject *watched, QEvent *event)
+{
+    Record record;
+    if (watched != d->decoration || !recordForType(event->type(), &record)) {
+        return false;
+    }
+    const qint64 now = d->timer.nsecsElapsed();
+    const qint64 delay = d->eventCount == 0 ? 0 : (now - d->lastEvent) / 1000;
+    d->lastEvent = now;
+    d->stream << quint8(record) << quint32(qMin<qint64>(delay, std::numeric_limits<quint32>::max()));
+
+    switch (record) {
+    case Record::HoverEnter:
+    case Record::HoverLeave:
+    case Record::HoverMove: {
+        const auto hoverEvent = static_cast<QHoverEvent*>(event);
+        d->stream << hoverEvent->posF() << hoverEvent->oldPosF() << quint32(hoverEvent->modifiers());
+        break;
+    }
+    case Record::MouseButtonPress:
+    case Record::MouseButtonRelease:
+    case Record::MouseMove: {
+        const auto mouseEvent = static_cast<QMouseEvent*>(event);
+        d->stream << mouseEvent->localPos() << quint32(mouseEvent->button())
+                  << quint32(mouseEvent->buttons()) << quint32(mouseEvent->modifiers());
+        break;
+    }
+    case Record::Wheel: {
+        const auto wheelEvent = static_cast<QWheelEvent*>(event);
+        d->stream << wheelEvent->position() << quint32(wheelEvent->buttons())
+                  << quint32(wheelEvent->modifiers()) << wheelEvent->angleDelta();
+        break;
+    }
+    }
+    d->eventCount++;
+    return false;
+}
+
+class Q_DECL_HIDDEN DecorationInputTrace::Private
+{
+public:
+    QSize clientSize;
+    QMargins borders;
+    QRect titleBar;
+    QVector<QRectF> buttonGeometries;
+    QVector<Event> events;
+};
+
+DecorationInputTrace::DecorationInputTrace()
+    : d(new Private)
+{
+}
+
+DecorationInputTrace::DecorationInputTrace(const DecorationInputTrace &other)
+    : d(new Private(*other.d))
+{
+}
+
+DecorationInputTrace &DecorationInputTrace::operator=(const DecorationInputTrace &other)
+{
+    *d = *other.d;
+    return *this;
+}
+
+DecorationInputTrace::~DecorationInputTrace() = default;
+
+bool DecorationInputTrace::load(QIODevice *device)
+{
+    *d = Private();
+    QDataStream stream(device);
+    setupStream(stream);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != s_magic || version != s_version) {
+        return false;
+    }
+    stream >> d->clientSize >> d->borders >> d->titleBar >> d->buttonGeometries;
+    if (stream.status() != QDataStream::Ok) {
+        *d = Private();
+        return false;
+    }
+
+    while (!stream.atEnd()) {
+        quint8 record = 0;
+        Event event;
+        stream >> record >> event.delay;
+        if (record > quint8(Record::Wheel)) {
+            // unknown record, the rest of the trace cannot be interpreted
+            break;
+        }
+        event.type = typeForRecord(Record(record));
+        quint32 button = 0;
+        quint32 buttons = 0;
+        quint32 modifiers = 0;
+        switch (Record(record)) {
+        case Record::HoverEnter:
+        case Record::HoverLeave:
+        case Record::HoverMove:
+            stream >> event.position >> event.oldPosition >> modifiers;
+            break;
+        case Record::MouseButtonPress:
+        case Record::MouseButtonRelease:
+        case Record::MouseMove:
+            stream >> event.position >> button >> buttons >> modifiers;
+            break;
+        case Record::Wheel:
+            stream >> event.position >> buttons >> modifiers >> event.angleDelta;
+            break;
+        }
+        if (stream.status() != QDataStream::Ok) {
+            break;
+        }
+        event.button = Qt::MouseButton(button);
+        event.buttons = Qt::MouseButtons(buttons);
+        event.modifiers = Qt::KeyboardModifiers(modifiers);
+        d->events << event;
+    }
+    return true;
+}
+
+QSize DecorationInputTrace::clientSize() const
+{
+    return d->clientSize;
+}
+
+QMargins DecorationInputTrace::borders() const
+{
+    return d->borders;
+}
+
+QRect DecorationInputTrace::titleBar() const
+{
+    return d->titleBar;
+}
+
+QVector<QRectF> DecorationInputTrace::buttonGeometries() const
+{
+    return d->buttonGeometries;
+}
+
+QVector<DecorationInputTrace::Event> DecorationInputTrace::events() const
+{
+    return d->events;
+}
+
+bool DecorationInputTrace::deliver(const Event &event, QObject *receiver)
+{
+    switch (event.type) {
+    case QEvent::HoverEnter:
+    case QEvent::HoverLeave:
+    case QEvent::HoverMove: {
+        QHoverEvent e(event.type, event.position, event.oldPosition, event.modifiers);
+        QCoreApplication::sendEvent(receiver, &e);
+        return e.isAccepted();
+    }
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseMove: {
+        QMouseEvent e(event.type, event.position, event.button, event.buttons, event.modifiers);
+        QCoreApplication::sendEvent(receiver, &e);
+        return e.isAccepted();
+    }
+    case QEvent::Wheel: {
+        QWheelEvent e(event.position, event.position, QPoint(), event.angleDelta,
+                      event.buttons, event.modifiers, Qt::NoScrollPhase, false);
+        QCoreApplication::sendEvent(receiver, &e);
+        return e.isAccepted();
+    }
+    default:
+        return false;
+    }
+}
+
+}
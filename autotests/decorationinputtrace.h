@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_INPUT_TRACE_H
+#define KDECORATION2_DECORATION_INPUT_TRACE_H
+
+#include <QEvent>
+#include <QMargins>
+#include <QObject>
+#include <QPointF>
+#include <QRect>
+#include <QScopedPointer>
+#include <QVector>
+
+class QIODevice;
+
+namespace KDecoration2
+{
+
+class Decoration;
+
+/**
+ * @brief Records the pointer events delivered to a Decoration into a binary trace.
+ *
+ * The DecorationInputRecorder installs an event filter on the Decoration and writes every
+ * QHoverEvent, QMouseEvent and QWheelEvent the Decoration receives to the QIODevice together
+ * with the time passed since the previous event. Positions are stored with single precision.
+ * The trace starts with a header describing the geometry of the Decoration and its buttons at
+ * the time the recording started, so that a replay can reproduce the hit testing.
+ *
+ * The recording stops when the DecorationInputRecorder or the Decoration gets destroyed. The
+ * QIODevice has to be open for writing and must outlive the DecorationInputRecorder.
+ *
+ * This is a debugging helper built with the autotests and the decorationReplay tool, it is
+ * not part of the installed libraries and only uses public API of the Decoration.
+ *
+ * @code
+ * QFile file(QStringLiteral("/tmp/decoration.trace"));
+ * file.open(QIODevice::WriteOnly);
+ * DecorationInputRecorder recorder(decoration, &file);
+ * @endcode
+ *
+ * @see DecorationInputTrace
+ **/
+class DecorationInputRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DecorationInputRecorder(Decoration *decoration, QIODevice *device, QObject *parent = nullptr);
+    ~DecorationInputRecorder() override;
+
+    /**
+     * @returns The number of events written to the trace.
+     **/
+    int eventCount() const;
+
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+/**
+ * @brief A trace written by DecorationInputRecorder.
+ *
+ * Use load to read a trace and deliver to send the recorded events to a Decoration again.
+ **/
+class DecorationInputTrace
+{
+public:
+    /**
+     * One recorded event.
+     **/
+    struct Event {
+        /**
+         * Time in microseconds since the previous event, @c 0 for the first event.
+         **/
+        quint32 delay = 0;
+        /**
+         * One of QEvent::HoverEnter, QEvent::HoverLeave, QEvent::HoverMove,
+         * QEvent::MouseButtonPress, QEvent::MouseButtonRelease, QEvent::MouseMove or QEvent::Wheel.
+         **/
+        QEvent::Type type = QEvent::None;
+        QPointF position;
+        /**
+         * The previous position for hover events.
+         **/
+        QPointF oldPosition;
+        Qt::MouseButton button = Qt::NoButton;
+        Qt::MouseButtons buttons = Qt::NoButton;
+        Qt::KeyboardModifiers modifiers = Qt::NoModifier;
+        /**
+         * The angle delta for wheel events.
+         **/
+        QPoint angleDelta;
+    };
+
+    DecorationInputTrace();
+    DecorationInputTrace(const DecorationInputTrace &other);
+    DecorationInputTrace &operator=(const DecorationInputTrace &other);
+    ~DecorationInputTrace();
+
+    /**
+     * Reads a trace from @p device.
+     * @returns @c false if @p device does not contain a trace of a supported version. The
+     * events read before a truncated record are kept.
+     **/
+    bool load(QIODevice *device);
+
+    /**
+     * The size of the DecoratedClient when the recording started.
+     **/
+    QSize clientSize() const;
+    /**
+     * The borders of the Decoration when the recording started.
+     **/
+    QMargins borders() const;
+    /**
+     * The title bar of the Decoration when the recording started.
+     **/
+    QRect titleBar() const;
+    /**
+     * The geometries of the buttons of the Decoration when the recording started.
+     **/
+    QVector<QRectF> buttonGeometries() const;
+    QVector<Event> events() const;
+
+    /**
+     * Sends the recorded @p event to @p receiver.
+     * @returns Whether the event got accepted.
+     **/
+    static bool deliver(const Event &event, QObject *receiver);
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+}
+
+Q_DECLARE_TYPEINFO(KDecoration2::DecorationInputTrace::Event, Q_MOVABLE_TYPE);
+
+#endif
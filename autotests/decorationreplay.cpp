@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+// Replays a trace written by KDecoration2::DecorationInputRecorder on a mock decoration
+// and reports the dispatch cost and the repaint requests per event type.
+//
+//   decorationReplay [--realtime] [--iterations <n>] <trace>
+#include "decorationinputtrace.h"
+#include "../src/decorationsettings.h"
+#include "mockbridge.h"
+#include "mockbutton.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QMap>
+#include <QMetaEnum>
+#include <QTextStream>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+namespace {
+struct EventTypeStatistics
+{
+    int count = 0;
+    qint64 totalNsecs = 0;
+    qint64 maxNsecs = 0;
+    quint64 updateRequests = 0;
+    int bridgeUpdates = 0;
+};
+}
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replays a decoration input trace on a mock decoration"));
+    parser.addHelpOption();
+    QCommandLineOption realTimeOption(QStringLiteral("realtime"), QStringLiteral("Keep the recorded delays between the events"));
+    QCommandLineOption iterationsOption(QStringLiteral("iterations"), QStringLiteral("Replay the trace <n> times"),
+                                        QStringLiteral("n"), QStringLiteral("1"));
+    parser.addOption(realTimeOption);
+    parser.addOption(iterationsOption);
+    parser.addPositionalArgument(QStringLiteral("trace"), QStringLiteral("The trace to replay"));
+    parser.process(app);
+    if (parser.positionalArguments().count() != 1) {
+        parser.showHelp(1);
+    }
+
+    QFile file(parser.positionalArguments().constFirst());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical("Cannot open %s", qPrintable(file.fileName()));
+        return 1;
+    }
+    KDecoration2::DecorationInputTrace trace;
+    if (!trace.load(&file)) {
+        qCritical("%s is not a decoration input trace", qPrintable(file.fileName()));
+        return 1;
+    }
+    const bool realTime = parser.isSet(realTimeOption);
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+
+    MockBridge bridge;
+    auto settings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration decoration(&bridge);
+    decoration.setSettings(settings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(trace.clientSize().width());
+    client->setHeight(trace.clientSize().height());
+    decoration.setBorders(trace.borders());
+    decoration.setTitleBar(trace.titleBar());
+    std::vector<std::unique_ptr<MockButton>> buttons;
+    for (const QRectF &geometry : trace.buttonGeometries()) {
+        buttons.emplace_back(new MockButton(KDecoration2::DecorationButtonType::Custom, &decoration));
+        buttons.back()->setGeometry(geometry);
+    }
+    QCoreApplication::processEvents();
+    bridge.clearUpdates();
+    decoration.setRepaintStatisticsEnabled(true);
+
+    const auto events = trace.events();
+    QMap<QEvent::Type, EventTypeStatistics> statistics;
+    QElapsedTimer replayTimer;
+    replayTimer.start();
+    for (int i = 0; i < iterations; ++i) {
+        qint64 scheduledNsecs = replayTimer.nsecsElapsed();
+        for (const auto &event : events) {
+            if (realTime) {
+                scheduledNsecs += qint64(event.delay) * 1000;
+                const qint64 remaining = scheduledNsecs - replayTimer.nsecsElapsed();
+                if (remaining > 0) {
+                    QThread::usleep(remaining / 1000);
+                }
+            }
+            const quint64 updateRequests = decoration.repaintStatistics().updateRequests;
+            const int bridgeUpdates = bridge.updates().count();
+
+            // the dispatch cost includes handing the collected damage to the bridge
+            QElapsedTimer timer;
+            timer.start();
+            KDecoration2::DecorationInputTrace::deliver(event, &decoration);
+            QCoreApplication::processEvents();
+            const qint64 nsecs = timer.nsecsElapsed();
+
+            EventTypeStatistics &s = statistics[event.type];
+            s.count++;
+            s.totalNsecs += nsecs;
+            s.maxNsecs = qMax(s.maxNsecs, nsecs);
+            s.updateRequests += decoration.repaintStatistics().updateRequests - updateRequests;
+            s.bridgeUpdates += bridge.updates().count() - bridgeUpdates;
+        }
+    }
+    const qint64 totalNsecs = replayTimer.nsecsElapsed();
+
+    QTextStream out(stdout);
+    const QMetaEnum eventTypes = QMetaEnum::fromType<QEvent::Type>();
+    out << "Replayed " << events.count() << " events " << iterations << " times with "
+        << int(buttons.size()) << " buttons in " << totalNsecs / 1000000.0 << " ms\n\n";
+    out << qSetFieldWidth(20) << Qt::left << "event" << qSetFieldWidth(10) << Qt::right
+        << "count" << "mean ns" << "max ns" << "updates" << "repaints" << qSetFieldWidth(0) << '\n';
+    for (auto it = statistics.constBegin(); it != statistics.constEnd(); ++it) {
+        out << qSetFieldWidth(20) << Qt::left << eventTypes.valueToKey(it.key()) << qSetFieldWidth(10) << Qt::right
+            << it->count << it->totalNsecs / it->count << it->maxNsecs
+            << it->updateRequests << it->bridgeUpdates << qSetFieldWidth(0) << '\n';
+    }
+    QString summary;
+    QDebug(&summary) << decoration.repaintStatistics();
+    out << '\n' << summary << '\n';
+    return 0;
+}
@@ -4,14 +4,28 @@
  * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
  */
 #include <QTest>
+#include <QBuffer>
+#include <QPainter>
 #include <QSignalSpy>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
 #include <QVariant>
+#include "../src/atomicsnapshot_p.h"
+#include "../src/decorationatlas.h"
+#include "decorationinputtrace.h"
+#include "../src/decorationoffscreenrenderer.h"
 #include "../src/decorationsettings.h"
+#include "../src/private/softwaredecorationbridge.h"
 #include "mockbridge.h"
+#include "mockbutton.h"
 #include "mockclient.h"
 #include "mockdecoration.h"
 #include "mocksettings.h"
 
+#include <atomic>
+
 class DecorationTest : public QObject
 {
     Q_OBJECT
@@ -20,6 +34,23 @@ private Q_SLOTS:
     void testOpaque();
     void testSection_data();
     void testSection();
+    void testSectionChanges();
+    void testHoverButtons();
+    void testPointerGrab();
+    void testToolTip();
+    void testInputTrace();
+    void testUpdate();
+    void testFrameParts();
+    void testSnapshot();
+    void testAtomicSnapshot();
+    void testRepaintStatistics();
+    void testSettingsSnapshot();
+    void testClientStateCache();
+    void testClientStateChange();
+    void testClientColors();
+    void testOffscreenRenderer();
+    void testAtlas();
+    void testSoftwareBridge();
 };
 
 #ifdef _MSC_VER
@@ -146,5 +177,1048 @@ void DecorationTest::testSection()
     QCOMPARE(spy.last().first().value<Qt::WindowFrameSection>(), Qt::NoSection);
 }
 
+void DecorationTest::testSectionChanges()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    bridge.lastCreatedSettings()->setLargeSpacing(0);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(100);
+    deco.setBorders(QMargins(1, 10, 1, 1));
+    deco.setTitleBar(QRect(1, 1, 98, 8));
+
+    QHoverEvent event(QEvent::HoverMove, QPointF(101, 50), QPointF(101, 50));
+    QCoreApplication::sendEvent(&deco, &event);
+    QCOMPARE(deco.sectionUnderMouse(), Qt::RightSection);
+
+    // growing the client moves the right border away from the pointer
+    client->setWidth(200);
+    QCoreApplication::sendEvent(&deco, &event);
+    QCOMPARE(deco.sectionUnderMouse(), Qt::NoSection);
+
+    // the left border grows under the pointer
+    deco.setBorders(QMargins(102, 10, 1, 1));
+    QCoreApplication::sendEvent(&deco, &event);
+    QCOMPARE(deco.sectionUnderMouse(), Qt::LeftSection);
+
+    // and the title bar covers it
+    deco.setTitleBar(QRect(0, 0, 302, 60));
+    QCoreApplication::sendEvent(&deco, &event);
+    QCOMPARE(deco.sectionUnderMouse(), Qt::TitleBarArea);
+}
+
+void DecorationTest::testHoverButtons()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+
+    MockButton button1(KDecoration2::DecorationButtonType::Custom, &deco);
+    button1.setGeometry(QRectF(0, 0, 10, 10));
+    MockButton button2(KDecoration2::DecorationButtonType::Custom, &deco);
+    button2.setGeometry(QRectF(10, 0, 10, 10));
+    QSignalSpy hovered1Spy(&button1, &KDecoration2::DecorationButton::hoveredChanged);
+    QVERIFY(hovered1Spy.isValid());
+    QSignalSpy hovered2Spy(&button2, &KDecoration2::DecorationButton::hoveredChanged);
+    QVERIFY(hovered2Spy.isValid());
+
+    QHoverEvent event(QEvent::HoverMove, QPointF(5, 5), QPointF(5, 5));
+    QCoreApplication::sendEvent(&deco, &event);
+    QCOMPARE(button1.isHovered(), true);
+    QCOMPARE(button2.isHovered(), false);
+    QCOMPARE(hovered1Spy.count(), 1);
+    QCOMPARE(hovered2Spy.count(), 0);
+
+    // moving within the button does not change the hover state
+    QHoverEvent event2(QEvent::HoverMove, QPointF(6, 5), QPointF(5, 5));
+    QCoreApplication::sendEvent(&deco, &event2);
+    QCOMPARE(hovered1Spy.count(), 1);
+    QCOMPARE(hovered2Spy.count(), 0);
+
+    QHoverEvent event3(QEvent::HoverMove, QPointF(15, 5), QPointF(6, 5));
+    QCoreApplication::sendEvent(&deco, &event3);
+    QCOMPARE(button1.isHovered(), false);
+    QCOMPARE(button2.isHovered(), true);
+    QCOMPARE(hovered1Spy.count(), 2);
+    QCOMPARE(hovered2Spy.count(), 1);
+
+    // moving the button away has to be picked up
+    button2.setGeometry(QRectF(30, 0, 10, 10));
+    QHoverEvent event4(QEvent::HoverMove, QPointF(16, 5), QPointF(15, 5));
+    QCoreApplication::sendEvent(&deco, &event4);
+    QCOMPARE(button2.isHovered(), false);
+    QCOMPARE(hovered2Spy.count(), 2);
+    QHoverEvent event5(QEvent::HoverMove, QPointF(35, 5), QPointF(16, 5));
+    QCoreApplication::sendEvent(&deco, &event5);
+    QCOMPARE(button2.isHovered(), true);
+    QCOMPARE(hovered2Spy.count(), 3);
+
+    // hidden buttons don't get hovered
+    button2.setVisible(false);
+    QCOMPARE(button2.isHovered(), false);
+    QCOMPARE(hovered2Spy.count(), 4);
+    QHoverEvent event6(QEvent::HoverMove, QPointF(36, 5), QPointF(35, 5));
+    QCoreApplication::sendEvent(&deco, &event6);
+    QCOMPARE(button2.isHovered(), false);
+    QCOMPARE(hovered2Spy.count(), 4);
+    QCOMPARE(hovered1Spy.count(), 2);
+}
+
+void DecorationTest::testPointerGrab()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+
+    MockButton button1(KDecoration2::DecorationButtonType::Custom, &deco);
+    button1.setGeometry(QRectF(0, 0, 10, 10));
+    MockButton button2(KDecoration2::DecorationButtonType::Custom, &deco);
+    button2.setGeometry(QRectF(10, 0, 10, 10));
+    QSignalSpy clicked1Spy(&button1, &KDecoration2::DecorationButton::clicked);
+    QVERIFY(clicked1Spy.isValid());
+    QSignalSpy pressed2Spy(&button2, &KDecoration2::DecorationButton::pressedChanged);
+    QVERIFY(pressed2Spy.isValid());
+
+    QHoverEvent hover(QEvent::HoverMove, QPointF(5, 5), QPointF(5, 5));
+    QCoreApplication::sendEvent(&deco, &hover);
+    QVERIFY(button1.isHovered());
+    QMouseEvent press(QEvent::MouseButtonPress, QPointF(5, 5), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &press);
+    QVERIFY(button1.isPressed());
+
+    // moving onto the other button is delivered to the pressed button
+    QMouseEvent move(QEvent::MouseMove, QPointF(15, 5), Qt::NoButton, Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &move);
+    QVERIFY(!button1.isHovered());
+    QVERIFY(button1.isPressed());
+    QMouseEvent release(QEvent::MouseButtonRelease, QPointF(15, 5), Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &release);
+    QVERIFY(!button1.isPressed());
+    QCOMPARE(clicked1Spy.count(), 0);
+    QCOMPARE(pressed2Spy.count(), 0);
+
+    // the grab ended, the next press goes to the hovered button
+    QHoverEvent hover2(QEvent::HoverMove, QPointF(15, 5), QPointF(5, 5));
+    QCoreApplication::sendEvent(&deco, &hover2);
+    QVERIFY(button2.isHovered());
+    QMouseEvent press2(QEvent::MouseButtonPress, QPointF(15, 5), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &press2);
+    QVERIFY(button2.isPressed());
+    QCOMPARE(pressed2Spy.count(), 1);
+
+    // disabling the pressed button ends the grab
+    button2.setEnabled(false);
+    QVERIFY(!button2.isPressed());
+    QCOMPARE(pressed2Spy.count(), 2);
+    QCoreApplication::sendEvent(&deco, &hover);
+    QCoreApplication::sendEvent(&deco, &press);
+    QVERIFY(button1.isPressed());
+    QMouseEvent release2(QEvent::MouseButtonRelease, QPointF(5, 5), Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &release2);
+    QCOMPARE(clicked1Spy.count(), 1);
+
+    // destroying the pressed button ends the grab
+    auto button3 = new MockButton(KDecoration2::DecorationButtonType::Custom, &deco);
+    button3->setGeometry(QRectF(20, 0, 10, 10));
+    QHoverEvent hover3(QEvent::HoverMove, QPointF(25, 5), QPointF(5, 5));
+    QCoreApplication::sendEvent(&deco, &hover3);
+    QMouseEvent press3(QEvent::MouseButtonPress, QPointF(25, 5), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &press3);
+    QVERIFY(button3->isPressed());
+    delete button3;
+    QMouseEvent move2(QEvent::MouseMove, QPointF(26, 5), Qt::NoButton, Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &move2);
+    QMouseEvent release3(QEvent::MouseButtonRelease, QPointF(26, 5), Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &release3);
+    QCOMPARE(clicked1Spy.count(), 1);
+
+    // of overlapping buttons the press goes to the first one in the order of the buttons,
+    // regardless of the order they got hovered in
+    MockButton button4(KDecoration2::DecorationButtonType::Custom, &deco);
+    button4.setGeometry(QRectF(30, 0, 20, 10));
+    MockButton button5(KDecoration2::DecorationButtonType::Custom, &deco);
+    button5.setGeometry(QRectF(40, 0, 20, 10));
+    QHoverEvent hover5(QEvent::HoverMove, QPointF(55, 5), QPointF(26, 5));
+    QCoreApplication::sendEvent(&deco, &hover5);
+    QVERIFY(!button4.isHovered());
+    QVERIFY(button5.isHovered());
+    QHoverEvent hoverOverlap(QEvent::HoverMove, QPointF(45, 5), QPointF(55, 5));
+    QCoreApplication::sendEvent(&deco, &hoverOverlap);
+    QVERIFY(button4.isHovered());
+    QVERIFY(button5.isHovered());
+    QMouseEvent press4(QEvent::MouseButtonPress, QPointF(45, 5), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &press4);
+    QVERIFY(button4.isPressed());
+    QVERIFY(!button5.isPressed());
+    QMouseEvent release4(QEvent::MouseButtonRelease, QPointF(45, 5), Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&deco, &release4);
+    QVERIFY(!button4.isPressed());
+}
+
+void DecorationTest::testToolTip()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    QSignalSpy showSpy(client, &MockClient::toolTipRequested);
+    QVERIFY(showSpy.isValid());
+    QSignalSpy hideSpy(client, &MockClient::hideToolTipRequested);
+    QVERIFY(hideSpy.isValid());
+    client->setMinimizable(true);
+    client->setMaximizable(true);
+    client->setCloseable(true);
+
+    MockButton minimize(KDecoration2::DecorationButtonType::Minimize, &deco);
+    minimize.setGeometry(QRectF(0, 0, 10, 10));
+    MockButton maximize(KDecoration2::DecorationButtonType::Maximize, &deco);
+    maximize.setGeometry(QRectF(10, 0, 10, 10));
+    MockButton close(KDecoration2::DecorationButtonType::Close, &deco);
+    close.setGeometry(QRectF(20, 0, 10, 10));
+    QCOMPARE(deco.toolTipDelay(), 0);
+    deco.setToolTipDelay(50);
+    QCOMPARE(deco.toolTipDelay(), 50);
+
+    // sweeping across all buttons results in one tooltip for the last one
+    QHoverEvent enter(QEvent::HoverMove, QPointF(5, 5), QPointF(5, 5));
+    QCoreApplication::sendEvent(&deco, &enter);
+    QHoverEvent move1(QEvent::HoverMove, QPointF(15, 5), QPointF(5, 5));
+    QCoreApplication::sendEvent(&deco, &move1);
+    QHoverEvent move2(QEvent::HoverMove, QPointF(25, 5), QPointF(15, 5));
+    QCoreApplication::sendEvent(&deco, &move2);
+    QVERIFY(showSpy.isEmpty());
+    QVERIFY(showSpy.wait());
+    QCOMPARE(showSpy.count(), 1);
+    const QString closeToolTip = showSpy.first().first().toString();
+    QVERIFY(!closeToolTip.isEmpty());
+    QVERIFY(hideSpy.isEmpty());
+
+    // leaving and entering the same button again keeps the tooltip
+    QHoverEvent move3(QEvent::HoverMove, QPointF(35, 5), QPointF(25, 5));
+    QCoreApplication::sendEvent(&deco, &move3);
+    QHoverEvent move4(QEvent::HoverMove, QPointF(25, 5), QPointF(35, 5));
+    QCoreApplication::sendEvent(&deco, &move4);
+    QTest::qWait(100);
+    QCOMPARE(showSpy.count(), 1);
+    QVERIFY(hideSpy.isEmpty());
+
+    // without delay each change is forwarded, the label follows the checked state
+    deco.setToolTipDelay(0);
+    QHoverEvent move5(QEvent::HoverMove, QPointF(15, 5), QPointF(25, 5));
+    QCoreApplication::sendEvent(&deco, &move5);
+    QCOMPARE(hideSpy.count(), 1);
+    QCOMPARE(showSpy.count(), 2);
+    const QString maximizeToolTip = showSpy.last().first().toString();
+    QVERIFY(maximizeToolTip != closeToolTip);
+    QHoverEvent leave(QEvent::HoverLeave, QPointF(50, 5), QPointF(15, 5));
+    QCoreApplication::sendEvent(&deco, &leave);
+    QCOMPARE(hideSpy.count(), 2);
+    maximize.setChecked(true);
+    QCoreApplication::sendEvent(&deco, &move5);
+    QCOMPARE(showSpy.count(), 3);
+    QVERIFY(showSpy.last().first().toString() != maximizeToolTip);
+    QCoreApplication::sendEvent(&deco, &leave);
+    maximize.setChecked(false);
+    QCoreApplication::sendEvent(&deco, &move5);
+    QCOMPARE(showSpy.count(), 4);
+    QCOMPARE(showSpy.last().first().toString(), maximizeToolTip);
+
+    // a pending tooltip is forwarded when the delay gets disabled
+    QCoreApplication::sendEvent(&deco, &leave);
+    QCOMPARE(hideSpy.count(), 4);
+    deco.setToolTipDelay(1000);
+    QCoreApplication::sendEvent(&deco, &move5);
+    QCOMPARE(showSpy.count(), 4);
+    deco.setToolTipDelay(0);
+    QCOMPARE(showSpy.count(), 5);
+}
+
+void DecorationTest::testInputTrace()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(100);
+    deco.setBorders(QMargins(0, 20, 0, 0));
+    deco.setTitleBar(QRect(0, 0, 100, 20));
+    MockButton button(KDecoration2::DecorationButtonType::Custom, &deco);
+    button.setGeometry(QRectF(0, 0, 10, 10));
+    QSignalSpy clickedSpy(&button, &KDecoration2::DecorationButton::clicked);
+    QVERIFY(clickedSpy.isValid());
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        KDecoration2::DecorationInputRecorder recorder(&deco, &buffer);
+        QHoverEvent hover(QEvent::HoverMove, QPointF(5.5, 5), QPointF(4, 5));
+        QCoreApplication::sendEvent(&deco, &hover);
+        QMouseEvent press(QEvent::MouseButtonPress, QPointF(5.5, 5), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+        QCoreApplication::sendEvent(&deco, &press);
+        QMouseEvent release(QEvent::MouseButtonRelease, QPointF(5.5, 5), Qt::LeftButton, Qt::NoButton, Qt::ShiftModifier);
+        QCoreApplication::sendEvent(&deco, &release);
+        // not a pointer event
+        QEvent other(QEvent::User);
+        QCoreApplication::sendEvent(&deco, &other);
+        QWheelEvent wheel(QPointF(50, 5), QPointF(50, 5), QPoint(), QPoint(0, 120),
+                          Qt::NoButton, Qt::NoModifier, Qt::NoScrollPhase, false);
+        QCoreApplication::sendEvent(&deco, &wheel);
+        QCOMPARE(recorder.eventCount(), 4);
+    }
+    QCOMPARE(clickedSpy.count(), 1);
+    buffer.close();
+
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    KDecoration2::DecorationInputTrace trace;
+    QVERIFY(trace.load(&buffer));
+    QCOMPARE(trace.clientSize(), QSize(100, 100));
+    QCOMPARE(trace.borders(), QMargins(0, 20, 0, 0));
+    QCOMPARE(trace.titleBar(), QRect(0, 0, 100, 20));
+    QCOMPARE(trace.buttonGeometries(), QVector<QRectF>({QRectF(0, 0, 10, 10)}));
+    const auto events = trace.events();
+    QCOMPARE(events.count(), 4);
+    QCOMPARE(events.at(0).type, QEvent::HoverMove);
+    QCOMPARE(events.at(0).delay, 0u);
+    QCOMPARE(events.at(0).position, QPointF(5.5, 5));
+    QCOMPARE(events.at(0).oldPosition, QPointF(4, 5));
+    QCOMPARE(events.at(1).type, QEvent::MouseButtonPress);
+    QCOMPARE(events.at(1).button, Qt::LeftButton);
+    QCOMPARE(events.at(1).buttons, Qt::MouseButtons(Qt::LeftButton));
+    QCOMPARE(events.at(2).type, QEvent::MouseButtonRelease);
+    QCOMPARE(events.at(2).buttons, Qt::MouseButtons(Qt::NoButton));
+    QCOMPARE(events.at(2).modifiers, Qt::KeyboardModifiers(Qt::ShiftModifier));
+    QCOMPARE(events.at(3).type, QEvent::Wheel);
+    QCOMPARE(events.at(3).position, QPointF(50, 5));
+    QCOMPARE(events.at(3).angleDelta, QPoint(0, 120));
+
+    // replaying clicks the button again
+    for (const auto &event : events) {
+        KDecoration2::DecorationInputTrace::deliver(event, &deco);
+    }
+    QCOMPARE(clickedSpy.count(), 2);
+
+    // a truncated trace keeps the complete events
+    QByteArray data = buffer.data();
+    data.chop(3);
+    QBuffer truncated(&data);
+    QVERIFY(truncated.open(QIODevice::ReadOnly));
+    QVERIFY(trace.load(&truncated));
+    QCOMPARE(trace.events().count(), 3);
+
+    QByteArray garbage("not a trace");
+    QBuffer invalid(&garbage);
+    QVERIFY(invalid.open(QIODevice::ReadOnly));
+    QVERIFY(!trace.load(&invalid));
+    QVERIFY(trace.events().isEmpty());
+}
+
+void DecorationTest::testUpdate()
+{
+    MockBridge bridge;
+    MockDecoration deco(&bridge);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(100);
+    QCoreApplication::processEvents();
+    bridge.clearUpdates();
+
+    // without borders there is no frame and the complete Decoration can be updated
+    QVERIFY(deco.frameRegion().isEmpty());
+    deco.update(QRect(20, 20, 10, 10));
+    QCoreApplication::processEvents();
+    QCOMPARE(bridge.updates(), QVector<QRect>({QRect(20, 20, 10, 10)}));
+    bridge.clearUpdates();
+    deco.update();
+    QCoreApplication::processEvents();
+    QCOMPARE(bridge.updates(), QVector<QRect>({QRect(0, 0, 100, 100)}));
+
+    deco.setBorders(QMargins(10, 10, 10, 10));
+    QCoreApplication::processEvents();
+    bridge.clearUpdates();
+
+    // overlapping requests get merged and delivered from the event loop
+    deco.update(QRect(0, 0, 10, 10));
+    deco.update(QRect(2, 2, 5, 5));
+    deco.update(QRect(0, 0, 10, 10));
+    QVERIFY(bridge.updates().isEmpty());
+    QCoreApplication::processEvents();
+    QCOMPARE(bridge.updates(), QVector<QRect>({QRect(0, 0, 10, 10)}));
+
+    // far apart areas are delivered individually
+    bridge.clearUpdates();
+    deco.update(QRect(0, 0, 10, 10));
+    deco.update(QRect(110, 110, 10, 10));
+    QCoreApplication::processEvents();
+    QCOMPARE(bridge.updates().count(), 2);
+    QVERIFY(bridge.updates().contains(QRect(0, 0, 10, 10)));
+    QVERIFY(bridge.updates().contains(QRect(110, 110, 10, 10)));
+
+    // a null rect updates the complete frame
+    bridge.clearUpdates();
+    deco.update();
+    QCoreApplication::processEvents();
+    QRegion updated;
+    for (const QRect &rect : bridge.updates()) {
+        updated += rect;
+    }
+    QCOMPARE(updated, deco.frameRegion());
+
+    // pending damage gets flushed when switching to synchronous updates
+    bridge.clearUpdates();
+    deco.update(QRect(0, 0, 10, 10));
+    deco.setSynchronousUpdates(true);
+    QCOMPARE(bridge.updates(), QVector<QRect>({QRect(0, 0, 10, 10)}));
+    deco.update(QRect(0, 0, 10, 10));
+    QCOMPARE(bridge.updates().count(), 2);
+}
+
+void DecorationTest::testFrameParts()
+{
+    MockBridge bridge;
+    MockDecoration deco(&bridge);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(80);
+    deco.setBorders(QMargins(2, 20, 3, 4));
+    QCOMPARE(deco.rect(), QRect(0, 0, 105, 104));
+
+    QCOMPARE(deco.framePartGeometry(Qt::TopEdge), QRect(0, 0, 105, 20));
+    QCOMPARE(deco.framePartGeometry(Qt::LeftEdge), QRect(0, 20, 2, 80));
+    QCOMPARE(deco.framePartGeometry(Qt::RightEdge), QRect(102, 20, 3, 80));
+    QCOMPARE(deco.framePartGeometry(Qt::BottomEdge), QRect(0, 100, 105, 4));
+    QCOMPARE(deco.frameRegion(), QRegion(deco.rect()) - QRect(2, 20, 100, 80));
+
+    // without side borders only the top and bottom parts remain
+    deco.setBorders(QMargins(0, 20, 0, 0));
+    QVERIFY(deco.framePartGeometry(Qt::LeftEdge).isEmpty());
+    QVERIFY(deco.framePartGeometry(Qt::RightEdge).isEmpty());
+    QVERIFY(deco.framePartGeometry(Qt::BottomEdge).isEmpty());
+    QCOMPARE(deco.frameRegion(), QRegion(0, 0, 100, 20));
+
+    // damage in the client area is dropped
+    QCoreApplication::processEvents();
+    bridge.clearUpdates();
+    deco.update(QRect(10, 30, 20, 20));
+    QCoreApplication::processEvents();
+    QVERIFY(bridge.updates().isEmpty());
+
+    // damage overlapping the client area is clipped to the frame
+    deco.update(QRect(10, 10, 20, 20));
+    QCoreApplication::processEvents();
+    QCOMPARE(bridge.updates(), QVector<QRect>({QRect(10, 10, 20, 10)}));
+}
+
+void DecorationTest::testSnapshot()
+{
+    MockBridge bridge;
+    MockDecoration deco(&bridge);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(80);
+    auto snapshot = deco.snapshot();
+    QCOMPARE(snapshot.size, QSize(100, 80));
+    QCOMPARE(snapshot.borders, QMargins());
+    QVERIFY(snapshot.shadow.isNull());
+
+    const quint64 serial = snapshot.serial;
+    deco.setBorders(QMargins(1, 20, 2, 3));
+    deco.setResizeOnlyBorders(QMargins(4, 4, 4, 4));
+    deco.setTitleBar(QRect(1, 0, 100, 20));
+    deco.setOpaque(true);
+    auto shadow = QSharedPointer<KDecoration2::DecorationShadow>::create();
+    deco.setShadow(shadow);
+    snapshot = deco.snapshot();
+    QCOMPARE(snapshot.borders, QMargins(1, 20, 2, 3));
+    QCOMPARE(snapshot.resizeOnlyBorders, QMargins(4, 4, 4, 4));
+    QCOMPARE(snapshot.titleBar, QRect(1, 0, 100, 20));
+    QCOMPARE(snapshot.size, QSize(103, 103));
+    QCOMPARE(snapshot.opaque, true);
+    QCOMPARE(snapshot.shadow, shadow);
+    QCOMPARE(snapshot.serial, serial + 4);
+
+    // a reader on another thread never sees a partially published state
+    deco.setBorders(QMargins(7, 7, 7, 7));
+    std::atomic<bool> stop{false};
+    std::atomic<int> inconsistent{0};
+    std::atomic<int> reads{0};
+    QScopedPointer<QThread> reader(QThread::create(
+        [&deco, &stop, &inconsistent, &reads] {
+            while (!stop.load()) {
+                const auto s = deco.snapshot();
+                const QMargins &b = s.borders;
+                if (b.left() != b.top() || b.left() != b.right() || b.left() != b.bottom()
+                        || s.size != QSize(100 + 2 * b.left(), 80 + 2 * b.top())) {
+                    inconsistent++;
+                }
+                reads++;
+            }
+        }
+    ));
+    reader->start();
+    for (int i = 0; i < 20000 || reads.load() == 0; ++i) {
+        deco.setBorders(QMargins(i % 7, i % 7, i % 7, i % 7));
+    }
+    stop = true;
+    QVERIFY(reader->wait());
+    QCOMPARE(inconsistent.load(), 0);
+}
+
+void DecorationTest::testAtomicSnapshot()
+{
+    KDecoration2::AtomicSnapshot<int> snapshot;
+    snapshot.publish(new int(0));
+    QCOMPARE(snapshot.retiredCount(), 0);
+    QCOMPARE(snapshot.load(), 0);
+
+    // a reader which is busy with a record holds back the records replaced meanwhile
+    QSemaphore pinned;
+    QSemaphore release1;
+    QSemaphore release2;
+    auto createReader = [&snapshot, &pinned](QSemaphore *release) {
+        return QThread::create(
+            [&snapshot, &pinned, release] {
+                snapshot.read([&pinned, release](const int &) {
+                    pinned.release();
+                    release->acquire();
+                });
+            }
+        );
+    };
+    QScopedPointer<QThread> reader1(createReader(&release1));
+    reader1->start();
+    pinned.acquire();
+    for (int i = 1; i <= 10; ++i) {
+        snapshot.publish(new int(i));
+    }
+    QCOMPARE(snapshot.retiredCount(), 10);
+    QCOMPARE(snapshot.load(), 10);
+
+    // the records replaced before the oldest pinned epoch are deleted even while a later
+    // reader is busy, so continuous reading does not let the retired records pile up
+    QScopedPointer<QThread> reader2(createReader(&release2));
+    reader2->start();
+    pinned.acquire();
+    release1.release();
+    QVERIFY(reader1->wait());
+    snapshot.publish(new int(11));
+    QCOMPARE(snapshot.retiredCount(), 1);
+
+    release2.release();
+    QVERIFY(reader2->wait());
+    snapshot.publish(new int(12));
+    QCOMPARE(snapshot.retiredCount(), 0);
+    QCOMPARE(snapshot.load(), 12);
+}
+
+void DecorationTest::testRepaintStatistics()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(100);
+    QCOMPARE(deco.isRepaintStatisticsEnabled(), false);
+    deco.setRepaintStatisticsEnabled(true);
+    QCOMPARE(deco.isRepaintStatisticsEnabled(), true);
+
+    // the frame is 120x130 pixels with a 120x20 top and 120x10 bottom part
+    deco.setBorders(QMargins(10, 20, 10, 10));
+    auto statistics = deco.repaintStatistics();
+    QCOMPARE(statistics.updateRequests, 1ull);
+    QCOMPARE(statistics.requestedArea, 5600ull);
+    QCOMPARE(statistics.causes.value(QByteArrayLiteral("bordersChanged")), 1ull);
+    QCOMPARE(statistics.flushes, 0ull);
+    QCoreApplication::processEvents();
+    statistics = deco.repaintStatistics();
+    QCOMPARE(statistics.flushes, 1ull);
+    QCOMPARE(statistics.flushedRects, 4ull);
+    QCOMPARE(statistics.flushedArea, 5600ull);
+    QCOMPARE(statistics.flushedAreaHistogram, QVector<quint64>({0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1}));
+
+    deco.resetRepaintStatistics();
+    QCOMPARE(deco.repaintStatistics().updateRequests, 0ull);
+    MockButton button(KDecoration2::DecorationButtonType::Custom, &deco);
+    button.setGeometry(QRectF(0, 0, 10, 10));
+    QHoverEvent event(QEvent::HoverMove, QPointF(5, 5), QPointF(5, 5));
+    QCoreApplication::sendEvent(&deco, &event);
+    QVERIFY(button.isHovered());
+    // inside the client area
+    deco.update(QRect(20, 40, 10, 10));
+    QCoreApplication::processEvents();
+
+    statistics = deco.repaintStatistics();
+    QCOMPARE(statistics.updateRequests, 3ull);
+    QCOMPARE(statistics.droppedRequests, 1ull);
+    QCOMPARE(statistics.requestedArea, 200ull);
+    QCOMPARE(statistics.coalescedRequests, 1ull);
+    QCOMPARE(statistics.flushes, 1ull);
+    QCOMPARE(statistics.flushedRects, 1ull);
+    QCOMPARE(statistics.flushedArea, 100ull);
+    QCOMPARE(statistics.causes.value(QByteArrayLiteral("geometryChanged")), 1ull);
+    QCOMPARE(statistics.causes.value(QByteArrayLiteral("hoveredChanged")), 1ull);
+    QCOMPARE(statistics.causes.value(QByteArrayLiteral("update")), 1ull);
+
+    auto buttonStatistics = button.repaintStatistics();
+    QCOMPARE(buttonStatistics.updateRequests, 2ull);
+    QCOMPARE(buttonStatistics.requestedArea, 200ull);
+    QCOMPARE(buttonStatistics.causes.count(), 2);
+    QCOMPARE(buttonStatistics.flushes, 0ull);
+
+    deco.setRepaintStatisticsEnabled(false);
+    QCOMPARE(deco.repaintStatistics().updateRequests, 0ull);
+    QCOMPARE(button.repaintStatistics().updateRequests, 0ull);
+    button.update();
+    QCOMPARE(button.repaintStatistics().updateRequests, 0ull);
+}
+
+void DecorationTest::testSettingsSnapshot()
+{
+    using KDecoration2::DecorationButtonType;
+    MockBridge bridge;
+    KDecoration2::DecorationSettings decoSettings(&bridge);
+    MockSettings *settings = bridge.lastCreatedSettings();
+    const KDecoration2::DecorationSettingsSnapshot &snapshot = decoSettings.snapshot();
+    QCOMPARE(&decoSettings.snapshot(), &snapshot);
+    // the getters keep asking the bridge unless it opts in
+    QVERIFY(!settings->isSettingsCacheEnabled());
+    QCOMPARE(snapshot.font(), decoSettings.font());
+    QCOMPARE(snapshot.fontMetrics().height(), QFontMetricsF(decoSettings.font()).height());
+    QVERIFY(snapshot.gridUnit() > 0);
+    QCOMPARE(snapshot.gridUnit(), decoSettings.gridUnit());
+    QCOMPARE(snapshot.largeSpacing(), decoSettings.largeSpacing());
+    QCOMPARE(snapshot.smallSpacing(), decoSettings.smallSpacing());
+    QCOMPARE(snapshot.borderSize(), decoSettings.borderSize());
+    QVERIFY(snapshot.decorationButtonsLeft().isEmpty());
+    const quint64 leftGeneration = snapshot.decorationButtonsLeftGeneration();
+    const quint64 rightGeneration = snapshot.decorationButtonsRightGeneration();
+
+    // the snapshot is updated before the change signal reaches other receivers
+    const QVector<DecorationButtonType> buttons{DecorationButtonType::Menu, DecorationButtonType::Close};
+    bool updated = false;
+    connect(&decoSettings, &KDecoration2::DecorationSettings::decorationButtonsLeftChanged, this,
+        [&snapshot, &buttons, &updated] {
+            updated = snapshot.decorationButtonsLeft() == buttons;
+        }
+    );
+    settings->setDecorationButtonsLeft(buttons);
+    QVERIFY(updated);
+    QCOMPARE(snapshot.decorationButtonsLeft(), buttons);
+    QCOMPARE(decoSettings.decorationButtonsLeft(), buttons);
+    QCOMPARE(snapshot.decorationButtonsLeftGeneration(), leftGeneration + 1);
+    QCOMPARE(snapshot.decorationButtonsRightGeneration(), rightGeneration);
+
+    // a change signal without a change of the content keeps the generation
+    emit decoSettings.decorationButtonsLeftChanged(buttons);
+    QCOMPARE(snapshot.decorationButtonsLeftGeneration(), leftGeneration + 1);
+}
+
+void DecorationTest::testClientStateCache()
+{
+    {
+        // the other tests cover the uncached path
+        MockBridge bridge;
+        MockDecoration deco(&bridge);
+        QVERIFY(!bridge.lastCreatedClient()->isStateCacheEnabled());
+    }
+    MockBridge bridge;
+    bridge.setClientStateCacheEnabled(true);
+    MockDecoration deco(&bridge);
+    MockClient *mockClient = bridge.lastCreatedClient();
+    QVERIFY(mockClient->isStateCacheEnabled());
+    KDecoration2::DecoratedClient *client = deco.client().toStrongRef().data();
+    QVERIFY(client);
+
+    // the cache is populated on creation
+    QCOMPARE(client->width(), 0);
+    QCOMPARE(client->isMaximized(), false);
+    QCOMPARE(client->desktop(), 1);
+
+    // width and height are always consistent with the size
+    QSize sizeInHandler;
+    connect(client, &KDecoration2::DecoratedClient::widthChanged, this,
+        [client, &sizeInHandler] {
+            sizeInHandler = client->size();
+        }
+    );
+    mockClient->setHeight(20);
+    mockClient->setWidth(10);
+    QCOMPARE(sizeInHandler, QSize(10, 20));
+    QCOMPARE(client->width(), 10);
+    QCOMPARE(client->height(), 20);
+    QCOMPARE(client->size(), QSize(10, 20));
+
+    // the maximized state is updated as a whole
+    bool maximizedInHandler = false;
+    connect(client, &KDecoration2::DecoratedClient::maximizedHorizontallyChanged, this,
+        [client, &maximizedInHandler] {
+            maximizedInHandler = client->isMaximized();
+        }
+    );
+    mockClient->requestToggleMaximization(Qt::LeftButton);
+    QCOMPARE(maximizedInHandler, true);
+    QCOMPARE(client->isMaximized(), true);
+    QCOMPARE(client->isMaximizedHorizontally(), true);
+    QCOMPARE(client->isMaximizedVertically(), true);
+
+    mockClient->setCloseable(true);
+    QCOMPARE(client->isCloseable(), true);
+}
+
+void DecorationTest::testClientStateChange()
+{
+    using KDecoration2::DecoratedClient;
+    MockBridge bridge;
+    MockDecoration deco(&bridge);
+    MockClient *mockClient = bridge.lastCreatedClient();
+    DecoratedClient *client = deco.client().toStrongRef().data();
+    QVERIFY(client);
+    QSignalSpy stateChangedSpy(client, &DecoratedClient::stateChanged);
+    QVERIFY(stateChangedSpy.isValid());
+
+    // changes outside of a batch are reported individually
+    mockClient->setWidth(10);
+    QCOMPARE(stateChangedSpy.count(), 1);
+    QCOMPARE(stateChangedSpy.last().first().value<DecoratedClient::StateChanges>(), DecoratedClient::StateChanges(DecoratedClient::StateChange::Width));
+
+    // a batch is reported once
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    deco.setSettings(decoSettings);
+    deco.setBorders(QMargins(5, 5, 5, 5));
+    // below the bottom border of the current size
+    QHoverEvent hover(QEvent::HoverMove, QPointF(107, 150), QPointF(107, 150));
+    QCoreApplication::sendEvent(&deco, &hover);
+    QCOMPARE(deco.sectionUnderMouse(), Qt::BottomRightSection);
+    const quint64 serial = deco.snapshot().serial;
+    mockClient->beginStateChange();
+    mockClient->requestToggleMaximization(Qt::LeftButton);
+    mockClient->beginStateChange();
+    mockClient->setWidth(100);
+    mockClient->setHeight(300);
+    // input during the batch already sees the new size
+    QCoreApplication::sendEvent(&deco, &hover);
+    QCOMPARE(deco.sectionUnderMouse(), Qt::RightSection);
+    QCOMPARE(deco.snapshot().serial, serial);
+    mockClient->endStateChange();
+    QCOMPARE(stateChangedSpy.count(), 1);
+    mockClient->endStateChange();
+    QCOMPARE(stateChangedSpy.count(), 2);
+    // and the Decoration updates its snapshot once for the whole resize
+    QCOMPARE(deco.snapshot().serial, serial + 1);
+    QCOMPARE(deco.snapshot().size, deco.size());
+    QCOMPARE(stateChangedSpy.last().first().value<DecoratedClient::StateChanges>(),
+             DecoratedClient::StateChange::Maximized | DecoratedClient::StateChange::MaximizedHorizontally |
+             DecoratedClient::StateChange::MaximizedVertically | DecoratedClient::StateChange::Width |
+             DecoratedClient::StateChange::Height);
+
+    // an empty batch is not reported
+    mockClient->beginStateChange();
+    mockClient->endStateChange();
+    QCOMPARE(stateChangedSpy.count(), 2);
+}
+
+void DecorationTest::testClientColors()
+{
+    MockBridge bridge;
+    {
+        // the color cache is opt-in
+        MockDecoration uncachedDeco(&bridge);
+        QVERIFY(!bridge.lastCreatedClient()->isColorCacheEnabled());
+    }
+    bridge.setClientColorCacheEnabled(true);
+    MockDecoration deco(&bridge);
+    MockClient *mockClient = bridge.lastCreatedClient();
+    QVERIFY(mockClient->isColorCacheEnabled());
+    KDecoration2::DecoratedClient *client = deco.client().toStrongRef().data();
+    QVERIFY(client);
+
+    QPalette palette;
+    palette.setColor(QPalette::Active, QPalette::Window, Qt::red);
+    palette.setColor(QPalette::Inactive, QPalette::Window, Qt::green);
+    mockClient->setPalette(palette);
+    QCOMPARE(client->color(QPalette::Active, QPalette::Window), QColor(Qt::red));
+    QCOMPARE(client->color(QPalette::Inactive, QPalette::Window), QColor(Qt::green));
+    QCOMPARE(client->color(QPalette::Active, QPalette::Window), QColor(Qt::red));
+
+    // a palette change drops the cached colors
+    palette.setColor(QPalette::Active, QPalette::Window, Qt::blue);
+    mockClient->setPalette(palette);
+    QCOMPARE(client->color(QPalette::Active, QPalette::Window), QColor(Qt::blue));
+    QCOMPARE(client->color(QPalette::Inactive, QPalette::Window), QColor(Qt::green));
+
+    // groups outside of the cache are resolved directly
+    QCOMPARE(client->color(QPalette::Current, QPalette::Window), palette.color(QPalette::Current, QPalette::Window));
+
+    // MockClient does not provide additional colors
+    QVERIFY(!client->color(KDecoration2::ColorGroup::Active, KDecoration2::ColorRole::TitleBar).isValid());
+}
+
+namespace {
+class FillingDecoration : public MockDecoration
+{
+public:
+    explicit FillingDecoration(MockBridge *bridge)
+        : MockDecoration(bridge)
+    {
+    }
+    explicit FillingDecoration(const QVariantList &args)
+        : MockDecoration(nullptr, args)
+    {
+    }
+    void paint(QPainter *painter, const QRect &repaintRegion) override
+    {
+        Q_UNUSED(repaintRegion)
+        paintThread = QThread::currentThread();
+        painter->fillRect(rect(), Qt::red);
+        painter->fillRect(titleBar(), Qt::blue);
+    }
+    QThread *paintThread = nullptr;
+};
+
+// leaves the painter with a different transform
+class TransformingDecoration : public FillingDecoration
+{
+public:
+    using FillingDecoration::FillingDecoration;
+    void paint(QPainter *painter, const QRect &repaintRegion) override
+    {
+        FillingDecoration::paint(painter, repaintRegion);
+        painter->translate(50, 50);
+    }
+};
+}
+
+void DecorationTest::testOffscreenRenderer()
+{
+    using KDecoration2::DecorationOffscreenRenderer;
+    MockBridge bridge;
+    FillingDecoration deco1(&bridge);
+    MockClient *client1 = bridge.lastCreatedClient();
+    client1->setWidth(100);
+    client1->setHeight(50);
+    deco1.setBorders(QMargins(2, 20, 3, 4));
+    deco1.setTitleBar(QRect(2, 0, 100, 20));
+    FillingDecoration deco2(&bridge);
+    MockClient *client2 = bridge.lastCreatedClient();
+    client2->setWidth(10);
+    client2->setHeight(10);
+    // a decoration without borders has no parts
+    MockDecoration deco3(&bridge);
+
+    DecorationOffscreenRenderer renderer;
+    const auto results = renderer.render({&deco1, &deco2, &deco3}, 2.0);
+    QCOMPARE(results.count(), 3);
+    QCOMPARE(results.at(0).decoration.data(), &deco1);
+    QCOMPARE(results.at(1).decoration.data(), &deco2);
+    QVERIFY(results.at(1).parts.isEmpty());
+    QVERIFY(results.at(2).parts.isEmpty());
+
+    const auto &parts = results.at(0).parts;
+    QCOMPARE(parts.count(), 4);
+    QCOMPARE(parts.at(0).edge, Qt::TopEdge);
+    QCOMPARE(parts.at(0).geometry, QRect(0, 0, 105, 20));
+    QCOMPARE(parts.at(1).edge, Qt::LeftEdge);
+    QCOMPARE(parts.at(1).geometry, QRect(0, 20, 2, 50));
+    QCOMPARE(parts.at(2).edge, Qt::RightEdge);
+    QCOMPARE(parts.at(2).geometry, QRect(102, 20, 3, 50));
+    QCOMPARE(parts.at(3).edge, Qt::BottomEdge);
+    QCOMPARE(parts.at(3).geometry, QRect(0, 70, 105, 4));
+    for (const auto &part : parts) {
+        QCOMPARE(part.image.size(), part.geometry.size() * 2);
+        QCOMPARE(part.image.devicePixelRatio(), 2.0);
+    }
+    QCOMPARE(parts.at(0).image.pixelColor(0, 0), QColor(Qt::red));
+    QCOMPARE(parts.at(0).image.pixelColor(10, 10), QColor(Qt::blue));
+    QCOMPARE(parts.at(3).image.pixelColor(209, 7), QColor(Qt::red));
+
+    // the calling thread renders itself if no thread of the pool is available
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    QSemaphore blocker;
+    pool.start(QRunnable::create([&blocker] { blocker.acquire(); }));
+    DecorationOffscreenRenderer busyRenderer(&pool);
+    const auto busyResults = busyRenderer.render({&deco1, &deco2}, 1.0);
+    blocker.release();
+    QVERIFY(pool.waitForDone());
+    QCOMPARE(busyResults.at(0).parts.count(), 4);
+    QCOMPARE(busyResults.at(0).parts.at(0).image.pixelColor(0, 0), QColor(Qt::red));
+
+    // the getters of MockClient and MockSettings call into the bridge, thus the calling
+    // thread paints all decorations
+    QThreadPool workers;
+    workers.setMaxThreadCount(4);
+    FillingDecoration deco4(&bridge);
+    bridge.lastCreatedClient()->setWidth(10);
+    deco4.setBorders(QMargins(1, 1, 1, 1));
+    DecorationOffscreenRenderer workerRenderer(&workers);
+    deco1.paintThread = nullptr;
+    workerRenderer.render({&deco1, &deco4}, 1.0);
+    QCOMPARE(deco1.paintThread, QThread::currentThread());
+    QCOMPARE(deco4.paintThread, QThread::currentThread());
+
+    // with all caches enabled the decorations are painted on the threads of the pool as well
+    MockBridge cachedBridge;
+    cachedBridge.setClientStateCacheEnabled(true);
+    cachedBridge.setClientColorCacheEnabled(true);
+    cachedBridge.setSettingsCacheEnabled(true);
+    auto cachedSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&cachedBridge);
+    QVector<KDecoration2::Decoration*> cachedDecorations;
+    for (int i = 0; i < 8; ++i) {
+        auto deco = new FillingDecoration(&cachedBridge);
+        deco->setSettings(cachedSettings);
+        cachedBridge.lastCreatedClient()->setWidth(100);
+        cachedBridge.lastCreatedClient()->setHeight(50);
+        deco->setBorders(QMargins(2, 20, 3, 4));
+        deco->setTitleBar(QRect(2, 0, 100, 20));
+        cachedDecorations << deco;
+    }
+    const auto cachedResults = workerRenderer.render(cachedDecorations, 1.0);
+    QCOMPARE(cachedResults.count(), 8);
+    for (const auto &result : cachedResults) {
+        QCOMPARE(result.parts.count(), 4);
+        QCOMPARE(result.parts.at(0).image.pixelColor(0, 0), QColor(Qt::red));
+        QCOMPARE(result.parts.at(0).image.pixelColor(10, 10), QColor(Qt::blue));
+    }
+    qDeleteAll(cachedDecorations);
+}
+
+void DecorationTest::testAtlas()
+{
+    using KDecoration2::DecorationAtlas;
+    MockBridge bridge;
+    TransformingDecoration deco1(&bridge);
+    MockClient *client1 = bridge.lastCreatedClient();
+    client1->setWidth(100);
+    client1->setHeight(50);
+    deco1.setBorders(QMargins(2, 20, 3, 4));
+    deco1.setTitleBar(QRect(2, 0, 100, 20));
+    FillingDecoration deco2(&bridge);
+    MockClient *client2 = bridge.lastCreatedClient();
+    client2->setWidth(120);
+    client2->setHeight(50);
+    deco2.setBorders(QMargins(2, 20, 3, 4));
+
+    DecorationAtlas atlas(QSize(128, 80));
+    QCOMPARE(atlas.mode(), DecorationAtlas::Mode::AllParts);
+    QVERIFY(atlas.addDecoration(&deco1));
+    QVERIFY(atlas.contains(&deco1));
+    const auto parts = atlas.parts(&deco1);
+    QCOMPARE(parts.count(), 4);
+    QCOMPARE(parts.at(0).edge, Qt::TopEdge);
+    QCOMPARE(parts.at(0).geometry, QRect(0, 0, 105, 20));
+    QCOMPARE(parts.at(0).atlasRect.size(), QSize(105, 20));
+    QCOMPARE(parts.at(3).atlasRect.size(), QSize(105, 4));
+    // the parts don't overlap and are inside the atlas
+    for (int i = 0; i < parts.count(); ++i) {
+        QVERIFY(QRect(QPoint(0, 0), atlas.size()).contains(parts.at(i).atlasRect));
+        for (int j = i + 1; j < parts.count(); ++j) {
+            QVERIFY(!parts.at(i).atlasRect.intersects(parts.at(j).atlasRect));
+        }
+    }
+
+    // the second decoration does not fit
+    QVERIFY(!atlas.addDecoration(&deco2));
+    QVERIFY(!atlas.contains(&deco2));
+    QVERIFY(atlas.parts(&deco2).isEmpty());
+
+    atlas.render(&deco1);
+    QCOMPARE(atlas.damage(), QRegion(parts.at(0).atlasRect) + parts.at(1).atlasRect + parts.at(2).atlasRect + parts.at(3).atlasRect);
+    QCOMPARE(atlas.image().pixelColor(parts.at(0).atlasRect.topLeft()), QColor(Qt::red));
+    QCOMPARE(atlas.image().pixelColor(parts.at(0).atlasRect.topLeft() + QPoint(10, 10)), QColor(Qt::blue));
+    QCOMPARE(atlas.image().pixelColor(parts.at(1).atlasRect.topLeft()), QColor(Qt::red));
+    atlas.clearDamage();
+    QVERIFY(atlas.damage().isEmpty());
+
+    // after removing the first one the space is available again
+    atlas.removeDecoration(&deco1);
+    QVERIFY(!atlas.contains(&deco1));
+    QVERIFY(atlas.addDecoration(&deco2));
+
+    // only the title bar
+    DecorationAtlas titleBarAtlas(QSize(256, 64), DecorationAtlas::Mode::TitleBarOnly, 2.0);
+    QVERIFY(titleBarAtlas.addDecoration(&deco1));
+    QCOMPARE(titleBarAtlas.parts(&deco1).count(), 1);
+    QCOMPARE(titleBarAtlas.parts(&deco1).first().atlasRect.size(), QSize(210, 40));
+}
+
+void DecorationTest::testSoftwareBridge()
+{
+    using KDecoration2::SoftwareDecorationBridge;
+    SoftwareDecorationBridge bridge;
+    FillingDecoration deco(QVariantList({QVariantMap({{QStringLiteral("bridge"), QVariant::fromValue<KDecoration2::DecorationBridge*>(&bridge)}})}));
+    auto settings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    deco.setSettings(settings);
+    QVERIFY(bridge.decorationSettings());
+    QCOMPARE(settings->borderSize(), KDecoration2::BorderSize::Normal);
+    bridge.decorationSettings()->setBorderSize(KDecoration2::BorderSize::Large);
+    QCOMPARE(settings->borderSize(), KDecoration2::BorderSize::Large);
+
+    KDecoration2::SoftwareDecoratedClient *client = bridge.client(&deco);
+    QVERIFY(client);
+    client->setSize(QSize(100, 50));
+    client->setCaption(QStringLiteral("caption"));
+    auto decoratedClient = deco.client().toStrongRef();
+    QCOMPARE(decoratedClient->size(), QSize(100, 50));
+    QCOMPARE(decoratedClient->caption(), QStringLiteral("caption"));
+    deco.setBorders(QMargins(2, 20, 3, 4));
+    deco.setTitleBar(QRect(2, 0, 100, 20));
+
+    // everything but the client area gets painted, one rect at a time
+    QCOMPARE(bridge.render(&deco), deco.frameRegion());
+    QImage image = bridge.image(&deco);
+    QCOMPARE(image.size(), QSize(105, 74));
+    QCOMPARE(image.pixelColor(50, 10), QColor(Qt::blue));
+    QCOMPARE(image.pixelColor(1, 10), QColor(Qt::red));
+    QCOMPARE(image.pixelColor(1, 40), QColor(Qt::red));
+    QCOMPARE(image.pixelColor(50, 40).alpha(), 0);
+    QCOMPARE(bridge.paintCount(&deco), 4ull);
+    QCOMPARE(bridge.paintedArea(&deco), quint64(105 * 74 - 100 * 50));
+    QCoreApplication::processEvents();
+    bridge.render(&deco);
+
+    // damage is collected till the next render
+    const quint64 paintCount = bridge.paintCount(&deco);
+    deco.update(QRect(0, 0, 10, 10));
+    QCoreApplication::processEvents();
+    QCOMPARE(bridge.damage(&deco), QRegion(0, 0, 10, 10));
+    QCOMPARE(bridge.render(&deco), QRegion(0, 0, 10, 10));
+    QVERIFY(bridge.damage(&deco).isEmpty());
+    QCOMPARE(bridge.paintCount(&deco), paintCount + 1);
+
+    int rendered = 0;
+    connect(&bridge, &SoftwareDecorationBridge::rendered, this,
+        [&rendered, &deco](KDecoration2::Decoration *decoration, const QRegion &region) {
+            QCOMPARE(decoration, &deco);
+            QCOMPARE(region, QRegion(0, 0, 10, 10));
+            rendered++;
+        }
+    );
+    bridge.setAutoRender(true);
+    deco.update(QRect(0, 0, 10, 10));
+    QTRY_COMPARE(rendered, 1);
+
+    // requests changing the window state are applied
+    deco.requestToggleMaximization(Qt::LeftButton);
+    QVERIFY(decoratedClient->isMaximized());
+    deco.requestToggleShade();
+    QVERIFY(decoratedClient->isShaded());
+    QCOMPARE(deco.size(), QSize(105, 24));
+
+    bridge.setDevicePixelRatio(2.0);
+    bridge.render(&deco);
+    image = bridge.image(&deco);
+    QCOMPARE(image.size(), QSize(210, 48));
+    QCOMPARE(image.devicePixelRatio(), 2.0);
+}
+
 QTEST_MAIN(DecorationTest)
 #include "decorationtest.moc"
@@ -10,14 +10,14 @@
 
 std::unique_ptr<KDecoration2::DecoratedClientPrivate> MockBridge::createClient(KDecoration2::DecoratedClient *client, KDecoration2::Decoration *decoration)
 {
-    auto ptr = std::unique_ptr<MockClient>(new MockClient(client, decoration));
+    auto ptr = std::unique_ptr<MockClient>(new MockClient(client, decoration, m_clientStateCacheEnabled, m_clientColorCacheEnabled));
     m_lastCreatedClient = ptr.get();
     return std::move(ptr);
 }
 
 std::unique_ptr<KDecoration2::DecorationSettingsPrivate> MockBridge::settings(KDecoration2::DecorationSettings *parent)
 {
-    auto ptr = std::unique_ptr<MockSettings>(new MockSettings(parent));
+    auto ptr = std::unique_ptr<MockSettings>(new MockSettings(parent, m_settingsCacheEnabled));
     m_lastCreatedSettings = ptr.get();
     return std::move(ptr);
 }
@@ -25,5 +25,5 @@ std::unique_ptr<KDecoration2::DecorationSettingsPrivate> MockBridge::settings(KD
 void MockBridge::update(KDecoration2::Decoration *decoration, const QRect &geometry)
 {
     Q_UNUSED(decoration)
-    Q_UNUSED(geometry)
+    m_updates << geometry;
 }
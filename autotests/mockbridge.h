@@ -8,6 +8,8 @@
 
 #include "../src/private/decorationbridge.h"
 #include <QObject>
+#include <QRect>
+#include <QVector>
 
 class MockClient;
 class MockSettings;
@@ -26,10 +28,31 @@ public:
     MockSettings *lastCreatedSettings() const {
         return m_lastCreatedSettings;
     }
+    QVector<QRect> updates() const {
+        return m_updates;
+    }
+    void clearUpdates() {
+        m_updates.clear();
+    }
+    // applies to the clients created afterwards
+    void setClientStateCacheEnabled(bool enabled) {
+        m_clientStateCacheEnabled = enabled;
+    }
+    void setClientColorCacheEnabled(bool enabled) {
+        m_clientColorCacheEnabled = enabled;
+    }
+    // applies to the settings created afterwards
+    void setSettingsCacheEnabled(bool enabled) {
+        m_settingsCacheEnabled = enabled;
+    }
 
 private:
     MockClient *m_lastCreatedClient = nullptr;
     MockSettings *m_lastCreatedSettings = nullptr;
+    QVector<QRect> m_updates;
+    bool m_clientStateCacheEnabled = false;
+    bool m_clientColorCacheEnabled = false;
+    bool m_settingsCacheEnabled = false;
 };
 
 #endif
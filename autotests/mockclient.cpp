@@ -8,10 +8,13 @@
 
 #include <QPalette>
 
-MockClient::MockClient(KDecoration2::DecoratedClient *client, KDecoration2::Decoration *decoration)
+MockClient::MockClient(KDecoration2::DecoratedClient *client, KDecoration2::Decoration *decoration, bool stateCacheEnabled, bool colorCacheEnabled)
     : QObject()
     , ApplicationMenuEnabledDecoratedClientPrivate(client, decoration)
 {
+    // all state changes are announced through the change signals
+    setStateCacheEnabled(stateCacheEnabled);
+    setColorCacheEnabled(colorCacheEnabled);
 }
 
 Qt::Edges MockClient::adjacentScreenEdges() const
@@ -121,7 +124,7 @@ bool MockClient::isShaded() const
 
 QPalette MockClient::palette() const
 {
-    return QPalette();
+    return m_palette;
 }
 
 bool MockClient::hasApplicationMenu() const
@@ -220,12 +223,12 @@ void MockClient::requestToggleShade()
 
 void MockClient::requestShowToolTip(const QString &text)
 {
-    Q_UNUSED(text);
+    emit toolTipRequested(text);
 }
 
 void MockClient::requestHideToolTip()
 {
-
+    emit hideToolTipRequested();
 }
 
 QSize MockClient::size() const
@@ -273,6 +276,12 @@ void MockClient::setMaximizable(bool set)
     emit client()->maximizeableChanged(set);
 }
 
+void MockClient::setPalette(const QPalette &palette)
+{
+    m_palette = palette;
+    emit client()->paletteChanged(m_palette);
+}
+
 void MockClient::setWidth(int w)
 {
     m_width = w;
@@ -9,12 +9,13 @@
 #include "../src/private/decoratedclientprivate.h"
 
 #include <QObject>
+#include <QPalette>
 
 class MockClient : public QObject, public KDecoration2::ApplicationMenuEnabledDecoratedClientPrivate
 {
     Q_OBJECT
 public:
-    explicit MockClient(KDecoration2::DecoratedClient *client, KDecoration2::Decoration *decoration);
+    explicit MockClient(KDecoration2::DecoratedClient *client, KDecoration2::Decoration *decoration, bool stateCacheEnabled = false, bool colorCacheEnabled = false);
 
     Qt::Edges adjacentScreenEdges() const override;
     QString caption() const override;
@@ -64,6 +65,7 @@ public:
     void setProvidesContextHelp(bool set);
     void setShadeable(bool set);
     void setMaximizable(bool set);
+    void setPalette(const QPalette &palette);
 
     void setWidth(int w);
     void setHeight(int h);
@@ -74,6 +76,8 @@ Q_SIGNALS:
     void quickHelpRequested();
     void menuRequested();
     void applicationMenuRequested();
+    void toolTipRequested(const QString &text);
+    void hideToolTipRequested();
 
 private:
     bool m_closeable = false;
@@ -89,6 +93,7 @@ private:
     bool m_onAllDesktops = false;
     int m_width = 0;
     int m_height = 0;
+    QPalette m_palette;
 };
 
 #endif
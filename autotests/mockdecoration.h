@@ -22,6 +22,8 @@ public:
     void setBorders(const QMargins &m);
     using Decoration::setTitleBar;
     void setTitleBar(const QRect &rect);
+    using Decoration::setResizeOnlyBorders;
+    using Decoration::setShadow;
 };
 
 #endif
@@ -6,9 +6,10 @@
 #include "mocksettings.h"
 #include "../src/decorationsettings.h"
 
-MockSettings::MockSettings(KDecoration2::DecorationSettings *parent)
+MockSettings::MockSettings(KDecoration2::DecorationSettings *parent, bool settingsCacheEnabled)
     : DecorationSettingsPrivate(parent)
 {
+    setSettingsCacheEnabled(settingsCacheEnabled);
 }
 
 KDecoration2::BorderSize MockSettings::borderSize() const
@@ -18,7 +19,7 @@ KDecoration2::BorderSize MockSettings::borderSize() const
 
 QVector< KDecoration2::DecorationButtonType > MockSettings::decorationButtonsLeft() const
 {
-    return QVector<KDecoration2::DecorationButtonType>();
+    return m_decorationButtonsLeft;
 }
 
 QVector< KDecoration2::DecorationButtonType > MockSettings::decorationButtonsRight() const
@@ -58,3 +59,12 @@ void MockSettings::setCloseOnDoubleClickOnMenu(bool set)
     m_closeDoubleClickOnMenu = set;
     emit decorationSettings()->closeOnDoubleClickOnMenuChanged(m_closeDoubleClickOnMenu);
 }
+
+void MockSettings::setDecorationButtonsLeft(const QVector<KDecoration2::DecorationButtonType> &buttons)
+{
+    if (m_decorationButtonsLeft == buttons) {
+        return;
+    }
+    m_decorationButtonsLeft = buttons;
+    emit decorationSettings()->decorationButtonsLeftChanged(m_decorationButtonsLeft);
+}
@@ -11,7 +11,7 @@
 class MockSettings : public KDecoration2::DecorationSettingsPrivate
 {
 public:
-    explicit MockSettings(KDecoration2::DecorationSettings *parent);
+    explicit MockSettings(KDecoration2::DecorationSettings *parent, bool settingsCacheEnabled = false);
 
     KDecoration2::BorderSize borderSize() const override;
     QVector< KDecoration2::DecorationButtonType > decorationButtonsLeft() const override;
@@ -22,10 +22,12 @@ public:
 
     void setOnAllDesktopsAvailabe(bool set);
     void setCloseOnDoubleClickOnMenu(bool set);
+    void setDecorationButtonsLeft(const QVector<KDecoration2::DecorationButtonType> &buttons);
 
 private:
     bool m_onAllDesktopsAvailable = false;
     bool m_closeDoubleClickOnMenu = false;
+    QVector<KDecoration2::DecorationButtonType> m_decorationButtonsLeft;
 };
 
 #endif
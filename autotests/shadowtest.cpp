@@ -7,6 +7,8 @@
 #include <QSignalSpy>
 #include "../src/decorationshadow.h"
 
+#include <algorithm>
+
 Q_DECLARE_METATYPE(QMargins)
 
 class DecorationShadowTest : public QObject
@@ -17,6 +19,8 @@ private Q_SLOTS:
     void testPadding();
     void testSizes_data();
     void testSizes();
+    void testShared();
+    void testTiles();
 };
 
 void DecorationShadowTest::testPadding_data()
@@ -126,5 +130,98 @@ void DecorationShadowTest::testSizes()
     QCOMPARE(shadow.innerShadowRect(), innerShadowRect.adjusted(1, 1, 1, 1));
 }
 
+void DecorationShadowTest::testShared()
+{
+    using namespace KDecoration2;
+    QImage image(QSize(6, 7), QImage::Format_ARGB32);
+    image.fill(Qt::black);
+    const QRect innerShadowRect(1, 2, 4, 4);
+    const QMargins padding(1, 2, 3, 4);
+
+    auto shadow = DecorationShadow::shared(image, innerShadowRect, padding);
+    QVERIFY(shadow);
+    QCOMPARE(shadow->shadow(), image);
+    QCOMPARE(shadow->innerShadowRect(), innerShadowRect);
+    QCOMPARE(shadow->padding(), padding);
+
+    // identical content is enough to share the instance
+    auto sameShadow = DecorationShadow::shared(image.copy(), innerShadowRect, padding);
+    QCOMPARE(sameShadow, shadow);
+
+    // but all parameters have to match
+    QVERIFY(DecorationShadow::shared(image, innerShadowRect, padding + 1) != shadow);
+    QVERIFY(DecorationShadow::shared(image, innerShadowRect.adjusted(0, 0, -1, 0), padding) != shadow);
+    QImage otherImage = image.copy();
+    otherImage.setPixel(0, 0, qRgba(255, 0, 0, 255));
+    QVERIFY(DecorationShadow::shared(otherImage, innerShadowRect, padding) != shadow);
+
+    // the padding at the end of the scanlines is not part of the content
+    const int bytesPerLine = 20;
+    QVector<uchar> data1(bytesPerLine * 7, 0);
+    QVector<uchar> data2(bytesPerLine * 7, 0xff);
+    for (int y = 0; y < 7; ++y) {
+        std::fill_n(data2.data() + y * bytesPerLine, 6 * 3, 0);
+    }
+    const QImage paddedImage1(data1.constData(), 6, 7, bytesPerLine, QImage::Format_RGB888);
+    const QImage paddedImage2(data2.constData(), 6, 7, bytesPerLine, QImage::Format_RGB888);
+    QCOMPARE(paddedImage1, paddedImage2);
+    auto paddedShadow = DecorationShadow::shared(paddedImage1, innerShadowRect, padding);
+    QCOMPARE(DecorationShadow::shared(paddedImage2, innerShadowRect, padding), paddedShadow);
+
+    // modifying a shared shadow removes it from the cache
+    shadow->setPadding(QMargins());
+    QCOMPARE(sameShadow->padding(), QMargins());
+    auto newShadow = DecorationShadow::shared(image, innerShadowRect, padding);
+    QVERIFY(newShadow != shadow);
+    QCOMPARE(newShadow->padding(), padding);
+}
+
+void DecorationShadowTest::testTiles()
+{
+    using namespace KDecoration2;
+    DecorationShadow shadow;
+    QVERIFY(shadow.tiles().isEmpty());
+    const quint64 initialVersion = shadow.version();
+
+    QImage image(QSize(6, 7), QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixel(x, y, qRgba(x * 10, y * 10, 0, 255));
+        }
+    }
+    shadow.setShadow(image);
+    QCOMPARE(shadow.version(), initialVersion + 1);
+    QVERIFY(shadow.tiles().isEmpty());
+    shadow.setInnerShadowRect(QRect(1, 2, 3, 4));
+    QCOMPARE(shadow.version(), initialVersion + 2);
+    const QImage firstTile = shadow.tiles().at(0);
+    shadow.setPadding(QMargins(1, 1, 1, 1));
+    QCOMPARE(shadow.version(), initialVersion + 3);
+    // the padding does not affect the tiles, they are not built again
+    QCOMPARE(shadow.tiles().at(0).cacheKey(), firstTile.cacheKey());
+    // setting the same value again does not change the version
+    shadow.setPadding(QMargins(1, 1, 1, 1));
+    QCOMPARE(shadow.version(), initialVersion + 3);
+
+    const QVector<QImage> tiles = shadow.tiles();
+    QCOMPARE(tiles.count(), 8);
+    const QVector<QRect> geometries = {
+        shadow.topLeftGeometry(), shadow.topGeometry(), shadow.topRightGeometry(), shadow.rightGeometry(),
+        shadow.bottomRightGeometry(), shadow.bottomGeometry(), shadow.bottomLeftGeometry(), shadow.leftGeometry()
+    };
+    const QImage shadowImage = shadow.shadow();
+    for (int i = 0; i < tiles.count(); ++i) {
+        QCOMPARE(tiles.at(i).size(), geometries.at(i).size());
+        QCOMPARE(tiles.at(i), image.copy(geometries.at(i)));
+        // the tile references the pixels of the shadow image
+        QCOMPARE(tiles.at(i).constBits(), shadowImage.constScanLine(geometries.at(i).y()) + geometries.at(i).x() * 4);
+    }
+
+    // the tiles stay valid after the shadow changed
+    shadow.setShadow(QImage(QSize(6, 7), QImage::Format_ARGB32_Premultiplied));
+    QCOMPARE(tiles.at(4), image.copy(geometries.at(4)));
+    QVERIFY(shadow.tiles().at(4).constBits() != tiles.at(4).constBits());
+}
+
 QTEST_MAIN(DecorationShadowTest)
 #include "shadowtest.moc"
@@ -0,0 +1,165 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_ATOMIC_SNAPSHOT_P_H
+#define KDECORATION2_ATOMIC_SNAPSHOT_P_H
+
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KDecoration2 API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+namespace KDecoration2
+{
+
+/**
+ * An immutable record of type @p T published by one writer thread and read without locks
+ * from any thread.
+ *
+ * publish replaces the current record as a whole. The replaced records are reclaimed per
+ * epoch: each publish starts a new epoch and a reader pins the epoch it started in while it
+ * accesses the record. A replaced record can only be in use by readers which pinned an epoch
+ * before it got replaced, so publish deletes all replaced records which are not younger than
+ * the oldest pinned epoch. A reader which keeps reading thus only holds back the records
+ * replaced during one of its reads. If all pin slots are in use a reader yields till one
+ * gets free.
+ **/
+template <typename T>
+class AtomicSnapshot
+{
+public:
+    AtomicSnapshot()
+    {
+        for (auto &pin : m_pins) {
+            pin.store(0);
+        }
+    }
+    ~AtomicSnapshot()
+    {
+        delete m_current.load();
+        for (const Retired &retired : m_retired) {
+            delete retired.record;
+        }
+    }
+
+    /**
+     * The current record, @c null before the first publish. Must only be called from the
+     * writer thread.
+     **/
+    const T *current() const
+    {
+        return m_current.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Replaces the current record with @p record, taking ownership of it. Must only be called
+     * from the writer thread.
+     **/
+    void publish(const T *record)
+    {
+        const T *previous = m_current.exchange(record);
+        // readers pinning the new epoch load the new record
+        const quint64 epoch = m_epoch.fetch_add(1) + 1;
+        if (previous) {
+            m_retired << Retired{previous, epoch};
+        }
+        reclaim();
+    }
+
+    /**
+     * Invokes @p function with the current record from any thread. The record stays valid
+     * till @p function returns. There has to be a published record.
+     **/
+    template <typename Function>
+    void read(Function function) const
+    {
+        std::atomic<quint64> &pin = pinEpoch();
+        function(*m_current.load());
+        pin.store(0);
+    }
+
+    /**
+     * Returns a copy of the current record, can be called from any thread.
+     **/
+    T load() const
+    {
+        T copy;
+        read([&copy](const T &record) {
+            copy = record;
+        });
+        return copy;
+    }
+
+    /**
+     * The number of replaced records which are not deleted yet.
+     **/
+    int retiredCount() const
+    {
+        return m_retired.size();
+    }
+
+private:
+    struct Retired {
+        const T *record;
+        // the epoch started by replacing the record
+        quint64 epoch;
+    };
+
+    std::atomic<quint64> &pinEpoch() const
+    {
+        while (true) {
+            for (auto &pin : m_pins) {
+                quint64 unused = 0;
+                if (pin.compare_exchange_strong(unused, m_epoch.load())) {
+                    return pin;
+                }
+            }
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    void reclaim()
+    {
+        quint64 oldest = m_epoch.load();
+        for (const auto &pin : m_pins) {
+            const quint64 epoch = pin.load();
+            if (epoch != 0) {
+                oldest = std::min(oldest, epoch);
+            }
+        }
+        auto it = std::remove_if(m_retired.begin(), m_retired.end(),
+            [oldest](const Retired &retired) {
+                if (retired.epoch > oldest) {
+                    return false;
+                }
+                delete retired.record;
+                return true;
+            }
+        );
+        m_retired.erase(it, m_retired.end());
+    }
+
+    std::atomic<const T*> m_current{nullptr};
+    // starts with 1 as 0 marks an unused pin
+    std::atomic<quint64> m_epoch{1};
+    mutable std::atomic<quint64> m_pins[16];
+    QVector<Retired> m_retired;
+};
+
+}
+
+#endif
@@ -17,6 +17,100 @@ DecoratedClient::DecoratedClient(Decoration *parent, DecorationBridge *bridge)
     : QObject()
     , d(std::move(bridge->createClient(this, parent)))
 {
+    auto invalidateColors = [this] {
+        d->invalidateColorCache();
+    };
+    connect(this, &DecoratedClient::paletteChanged, this, invalidateColors);
+    connect(this, &DecoratedClient::activeChanged, this, invalidateColors);
+
+    if (d->isStateCacheEnabled()) {
+        DecoratedClientPrivate::CachedState &state = d->cachedState();
+        // modal is a constant property, there is no change signal to refresh it
+        state.modal = d->isModal();
+        // the cached values are refreshed from the bridge when the change signal gets emitted
+#define CACHE(signal, field, method) \
+        state.field = d->method(); \
+        connect(this, &DecoratedClient::signal, this, [this] { d->cachedState().field = d->method(); });
+
+        CACHE(activeChanged, active, isActive)
+        CACHE(captionChanged, caption, caption)
+        CACHE(desktopChanged, desktop, desktop)
+        CACHE(onAllDesktopsChanged, onAllDesktops, isOnAllDesktops)
+        CACHE(shadedChanged, shaded, isShaded)
+        CACHE(iconChanged, icon, icon)
+        CACHE(keepAboveChanged, keepAbove, isKeepAbove)
+        CACHE(keepBelowChanged, keepBelow, isKeepBelow)
+        CACHE(closeableChanged, closeable, isCloseable)
+        CACHE(maximizeableChanged, maximizeable, isMaximizeable)
+        CACHE(minimizeableChanged, minimizeable, isMinimizeable)
+        CACHE(providesContextHelpChanged, providesContextHelp, providesContextHelp)
+        CACHE(shadeableChanged, shadeable, isShadeable)
+        CACHE(moveableChanged, moveable, isMoveable)
+        CACHE(resizeableChanged, resizeable, isResizeable)
+        CACHE(paletteChanged, palette, palette)
+        CACHE(adjacentScreenEdgesChanged, adjacentScreenEdges, adjacentScreenEdges)
+
+#undef CACHE
+
+        // related values are refreshed together as bridges emit their change signals one
+        // after another in varying order
+        auto updateMaximized = [this] {
+            DecoratedClientPrivate::CachedState &state = d->cachedState();
+            state.maximized = d->isMaximized();
+            state.maximizedHorizontally = d->isMaximizedHorizontally();
+            state.maximizedVertically = d->isMaximizedVertically();
+        };
+        updateMaximized();
+        connect(this, &DecoratedClient::maximizedChanged, this, updateMaximized);
+        connect(this, &DecoratedClient::maximizedHorizontallyChanged, this, updateMaximized);
+        connect(this, &DecoratedClient::maximizedVerticallyChanged, this, updateMaximized);
+        auto updateSize = [this] {
+            DecoratedClientPrivate::CachedState &state = d->cachedState();
+            state.width = d->width();
+            state.height = d->height();
+        };
+        updateSize();
+        connect(this, &DecoratedClient::widthChanged, this, updateSize);
+        connect(this, &DecoratedClient::heightChanged, this, updateSize);
+        connect(this, &DecoratedClient::sizeChanged, this, updateSize);
+    }
+
+    // connected after the cache, so that the receivers of stateChanged see the new values
+    d->setStateChangeCallback(
+        [this](uint changes) {
+            emit stateChanged(StateChanges(changes));
+        }
+    );
+#define TRACK(signal, change) \
+    connect(this, &DecoratedClient::signal, this, [this] { d->addStateChange(uint(StateChange::change)); });
+
+    TRACK(activeChanged, Active)
+    TRACK(captionChanged, Caption)
+    TRACK(desktopChanged, Desktop)
+    TRACK(onAllDesktopsChanged, OnAllDesktops)
+    TRACK(shadedChanged, Shaded)
+    TRACK(iconChanged, Icon)
+    TRACK(maximizedChanged, Maximized)
+    TRACK(maximizedHorizontallyChanged, MaximizedHorizontally)
+    TRACK(maximizedVerticallyChanged, MaximizedVertically)
+    TRACK(keepAboveChanged, KeepAbove)
+    TRACK(keepBelowChanged, KeepBelow)
+    TRACK(closeableChanged, Closeable)
+    TRACK(maximizeableChanged, Maximizeable)
+    TRACK(minimizeableChanged, Minimizeable)
+    TRACK(providesContextHelpChanged, ProvidesContextHelp)
+    TRACK(shadeableChanged, Shadeable)
+    TRACK(moveableChanged, Moveable)
+    TRACK(resizeableChanged, Resizeable)
+    TRACK(widthChanged, Width)
+    TRACK(heightChanged, Height)
+    TRACK(sizeChanged, Size)
+    TRACK(paletteChanged, Palette)
+    TRACK(adjacentScreenEdgesChanged, AdjacentScreenEdges)
+    TRACK(hasApplicationMenuChanged, HasApplicationMenu)
+    TRACK(applicationMenuActiveChanged, ApplicationMenuActive)
+
+#undef TRACK
 }
 
 DecoratedClient::~DecoratedClient() = default;
@@ -27,35 +121,53 @@ type DecoratedClient::method() const \
     return d->method(); \
 }
 
-DELEGATE(bool, isActive)
-DELEGATE(QString, caption)
-DELEGATE(int, desktop)
-DELEGATE(bool, isOnAllDesktops)
-DELEGATE(bool, isShaded)
-DELEGATE(QIcon, icon)
-DELEGATE(bool, isMaximized)
-DELEGATE(bool, isMaximizedHorizontally)
-DELEGATE(bool, isMaximizedVertically)
-DELEGATE(bool, isKeepAbove)
-DELEGATE(bool, isKeepBelow)
-DELEGATE(bool, isCloseable)
-DELEGATE(bool, isMaximizeable)
-DELEGATE(bool, isMinimizeable)
-DELEGATE(bool, providesContextHelp)
-DELEGATE(bool, isModal)
-DELEGATE(bool, isShadeable)
-DELEGATE(bool, isMoveable)
-DELEGATE(bool, isResizeable)
+#define CACHED(type, method, field) \
+type DecoratedClient::method() const \
+{ \
+    if (d->isStateCacheEnabled()) { \
+        return d->cachedState().field; \
+    } \
+    return d->method(); \
+}
+
+CACHED(bool, isActive, active)
+CACHED(QString, caption, caption)
+CACHED(int, desktop, desktop)
+CACHED(bool, isOnAllDesktops, onAllDesktops)
+CACHED(bool, isShaded, shaded)
+CACHED(QIcon, icon, icon)
+CACHED(bool, isMaximized, maximized)
+CACHED(bool, isMaximizedHorizontally, maximizedHorizontally)
+CACHED(bool, isMaximizedVertically, maximizedVertically)
+CACHED(bool, isKeepAbove, keepAbove)
+CACHED(bool, isKeepBelow, keepBelow)
+CACHED(bool, isCloseable, closeable)
+CACHED(bool, isMaximizeable, maximizeable)
+CACHED(bool, isMinimizeable, minimizeable)
+CACHED(bool, providesContextHelp, providesContextHelp)
+CACHED(bool, isModal, modal)
+CACHED(bool, isShadeable, shadeable)
+CACHED(bool, isMoveable, moveable)
+CACHED(bool, isResizeable, resizeable)
 DELEGATE(WId, windowId)
 DELEGATE(WId, decorationId)
-DELEGATE(int, width)
-DELEGATE(int, height)
-DELEGATE(QSize, size)
-DELEGATE(QPalette, palette)
-DELEGATE(Qt::Edges, adjacentScreenEdges)
+CACHED(int, width, width)
+CACHED(int, height, height)
+CACHED(QPalette, palette, palette)
+CACHED(Qt::Edges, adjacentScreenEdges, adjacentScreenEdges)
 
+#undef CACHED
 #undef DELEGATE
 
+QSize DecoratedClient::size() const
+{
+    if (d->isStateCacheEnabled()) {
+        const DecoratedClientPrivate::CachedState &state = d->cachedState();
+        return QSize(state.width, state.height);
+    }
+    return d->size();
+}
+
 bool DecoratedClient::hasApplicationMenu() const
 {
     if (const auto *appMenuEnabledPrivate = dynamic_cast<ApplicationMenuEnabledDecoratedClientPrivate *>(d.get())) {
@@ -79,12 +191,12 @@ QPointer< Decoration > DecoratedClient::decoration() const
 
 QColor DecoratedClient::color(QPalette::ColorGroup group, QPalette::ColorRole role) const
 {
-    return d->palette().color(group, role);
+    return d->cachedColor(group, role);
 }
 
 QColor DecoratedClient::color(ColorGroup group, ColorRole role) const
 {
-    return d->color(group, role);
+    return d->cachedColor(group, role);
 }
 
 void DecoratedClient::showApplicationMenu(int actionId)
@@ -172,6 +172,40 @@ class KDECORATIONS2_EXPORT DecoratedClient : public QObject
     // TODO: properties for windowId and decorationId?
 
 public:
+    /**
+     * The properties reported as changed by stateChanged.
+     * @since 5.21
+     **/
+    enum class StateChange : uint {
+        Active = 1 << 0,
+        Caption = 1 << 1,
+        Desktop = 1 << 2,
+        OnAllDesktops = 1 << 3,
+        Shaded = 1 << 4,
+        Icon = 1 << 5,
+        Maximized = 1 << 6,
+        MaximizedHorizontally = 1 << 7,
+        MaximizedVertically = 1 << 8,
+        KeepAbove = 1 << 9,
+        KeepBelow = 1 << 10,
+        Closeable = 1 << 11,
+        Maximizeable = 1 << 12,
+        Minimizeable = 1 << 13,
+        ProvidesContextHelp = 1 << 14,
+        Shadeable = 1 << 15,
+        Moveable = 1 << 16,
+        Resizeable = 1 << 17,
+        Width = 1 << 18,
+        Height = 1 << 19,
+        Size = 1 << 20,
+        Palette = 1 << 21,
+        AdjacentScreenEdges = 1 << 22,
+        HasApplicationMenu = 1 << 23,
+        ApplicationMenuActive = 1 << 24
+    };
+    Q_DECLARE_FLAGS(StateChanges, StateChange)
+    Q_FLAG(StateChanges)
+
     DecoratedClient() = delete;
     ~DecoratedClient() override;
     bool isActive() const;
@@ -271,12 +305,25 @@ Q_SIGNALS:
     void hasApplicationMenuChanged(bool);
     void applicationMenuActiveChanged(bool);
 
+    /**
+     * Emitted once for all properties which changed in a batch of state changes of the
+     * bridge, e.g. a maximization changing the maximized states and the size. Connecting to
+     * this signal allows to react to such a change once instead of once per individual change
+     * signal. Changes outside of a batch are reported immediately after the individual change
+     * signal.
+     * @since 5.21
+     **/
+    void stateChanged(KDecoration2::DecoratedClient::StateChanges changes);
+
 private:
     friend class Decoration;
+    friend class DecorationOffscreenRenderer;
     DecoratedClient(Decoration *parent, DecorationBridge *bridge);
     const std::unique_ptr<DecoratedClientPrivate> d;
 };
 
 } // namespace
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(KDecoration2::DecoratedClient::StateChanges)
+
 #endif
@@ -12,12 +12,46 @@
 #include "decorationsettings.h"
 
 #include <QCoreApplication>
+#include <QDebug>
 #include <QHoverEvent>
+#include <QLoggingCategory>
+#include <QMetaMethod>
+#include <QTimer>
+
+#include <algorithm>
+#include <limits>
 
 namespace KDecoration2
 {
 
+Q_LOGGING_CATEGORY(KDECORATION2_REPAINT, "kdecoration.repaint", QtWarningMsg)
+
 namespace {
+quint64 area(const QRect &rect)
+{
+    return quint64(rect.width()) * quint64(rect.height());
+}
+
+quint64 area(const QRegion &region)
+{
+    quint64 result = 0;
+    for (const QRect &rect : region) {
+        result += area(rect);
+    }
+    return result;
+}
+
+void recordRequest(DecorationRepaintStatistics &statistics, const QRegion &region, const QByteArray &cause)
+{
+    statistics.updateRequests++;
+    statistics.causes[cause]++;
+    if (region.isEmpty()) {
+        statistics.droppedRequests++;
+    } else {
+        statistics.requestedArea += area(region);
+    }
+}
+
 DecorationBridge *findBridge(const QVariantList &args)
 {
     for (const auto &arg: args) {
@@ -37,8 +71,13 @@ Decoration::Private::Private(Decoration *deco, const QVariantList &args)
     , q(deco)
 {
     Q_UNUSED(args)
+    if (KDECORATION2_REPAINT().isDebugEnabled()) {
+        repaintStatistics.reset(new DecorationRepaintStatistics);
+    }
 }
 
+Decoration::Private::~Private() = default;
+
 void Decoration::Private::setSectionUnderMouse(Qt::WindowFrameSection section)
 {
     if (sectionUnderMouse == section) {
@@ -48,73 +87,275 @@ void Decoration::Private::setSectionUnderMouse(Qt::WindowFrameSection section)
     emit q->sectionUnderMouseChanged(sectionUnderMouse);
 }
 
-void Decoration::Private::updateSectionUnderMouse(const QPoint &mousePosition)
+Qt::WindowFrameSection Decoration::Private::sectionAt(const QPoint &mousePosition, const QSize &size, int corner) const
 {
     if (titleBar.contains(mousePosition)) {
-        setSectionUnderMouse(Qt::TitleBarArea);
-        return;
+        return Qt::TitleBarArea;
     }
-    const QSize size = q->size();
-    const int corner = 2*settings->largeSpacing();
     const bool left   = mousePosition.x() < borders.left();
     const bool top    = mousePosition.y() < borders.top();
     const bool bottom = size.height() - mousePosition.y() <= borders.bottom();
     const bool right  = size.width() - mousePosition.x() <= borders.right();
     if (left) {
         if (top && mousePosition.y() < titleBar.top() + corner) {
-            setSectionUnderMouse(Qt::TopLeftSection);
+            return Qt::TopLeftSection;
         } else if (size.height() - mousePosition.y() <= borders.bottom() + corner && mousePosition.y() > titleBar.bottom()) {
-            setSectionUnderMouse(Qt::BottomLeftSection);
+            return Qt::BottomLeftSection;
         } else {
-            setSectionUnderMouse(Qt::LeftSection);
+            return Qt::LeftSection;
         }
-        return;
     }
     if (right) {
         if (top && mousePosition.y() < titleBar.top() + corner) {
-            setSectionUnderMouse(Qt::TopRightSection);
+            return Qt::TopRightSection;
         } else if (size.height() - mousePosition.y() <= borders.bottom() + corner && mousePosition.y() > titleBar.bottom()) {
-            setSectionUnderMouse(Qt::BottomRightSection);
+            return Qt::BottomRightSection;
         } else {
-            setSectionUnderMouse(Qt::RightSection);
+            return Qt::RightSection;
         }
-        return;
     }
     if (bottom) {
         if (mousePosition.y() > titleBar.bottom()) {
             if (mousePosition.x() < borders.left() + corner) {
-                setSectionUnderMouse(Qt::BottomLeftSection);
+                return Qt::BottomLeftSection;
             } else if (size.width() - mousePosition.x() <= borders.right() + corner) {
-                setSectionUnderMouse(Qt::BottomRightSection);
+                return Qt::BottomRightSection;
             } else {
-                setSectionUnderMouse(Qt::BottomSection);
+                return Qt::BottomSection;
             }
         } else {
-            setSectionUnderMouse(Qt::TitleBarArea);
+            return Qt::TitleBarArea;
         }
-        return;
     }
     if (top) {
         if (mousePosition.y() < titleBar.top()) {
             if (mousePosition.x() < borders.left() + corner) {
-                setSectionUnderMouse(Qt::TopLeftSection);
+                return Qt::TopLeftSection;
             } else if (size.width() - mousePosition.x() <= borders.right() + corner) {
-                setSectionUnderMouse(Qt::TopRightSection);
+                return Qt::TopRightSection;
             } else {
-                setSectionUnderMouse(Qt::TopSection);
+                return Qt::TopSection;
             }
         } else {
-            setSectionUnderMouse(Qt::TitleBarArea);
+            return Qt::TitleBarArea;
+        }
+    }
+    return Qt::NoSection;
+}
+
+void Decoration::Private::updateSectionMap()
+{
+    const QSize size = q->size();
+    const int corner = 2*settings->largeSpacing();
+    const QRect normalizedTitleBar = titleBar.normalized();
+    // each comparison in sectionAt has the form "coordinate < threshold", thus the
+    // result is constant between two consecutive thresholds
+    sectionXBands = {
+        normalizedTitleBar.left(), normalizedTitleBar.right() + 1,
+        borders.left(), borders.left() + corner,
+        size.width() - borders.right() - corner, size.width() - borders.right()
+    };
+    sectionYBands = {
+        normalizedTitleBar.top(), normalizedTitleBar.bottom() + 1,
+        titleBar.top(), titleBar.top() + corner, titleBar.bottom() + 1,
+        borders.top(),
+        size.height() - borders.bottom() - corner, size.height() - borders.bottom()
+    };
+    for (QVector<int> *bands : {&sectionXBands, &sectionYBands}) {
+        std::sort(bands->begin(), bands->end());
+        bands->erase(std::unique(bands->begin(), bands->end()), bands->end());
+    }
+    // band i covers [bands[i - 1], bands[i]), use its first coordinate as representative
+    auto representative = [](const QVector<int> &bands, int band) {
+        return band == 0 ? bands.first() - 1 : bands.at(band - 1);
+    };
+    const int columns = sectionYBands.count() + 1;
+    sectionMap.resize((sectionXBands.count() + 1) * columns);
+    for (int x = 0; x <= sectionXBands.count(); ++x) {
+        for (int y = 0; y < columns; ++y) {
+            const QPoint pos(representative(sectionXBands, x), representative(sectionYBands, y));
+            sectionMap[x * columns + y] = sectionAt(pos, size, corner);
+        }
+    }
+    sectionMapValid = true;
+}
+
+void Decoration::Private::invalidateSectionMap()
+{
+    sectionMapValid = false;
+}
+
+void Decoration::Private::updateSectionUnderMouse(const QPoint &mousePosition)
+{
+    if (!sectionMapValid) {
+        updateSectionMap();
+    }
+    const int x = std::upper_bound(sectionXBands.constBegin(), sectionXBands.constEnd(), mousePosition.x()) - sectionXBands.constBegin();
+    const int y = std::upper_bound(sectionYBands.constBegin(), sectionYBands.constEnd(), mousePosition.y()) - sectionYBands.constBegin();
+    setSectionUnderMouse(sectionMap.at(x * (sectionYBands.count() + 1) + y));
+}
+
+QByteArray Decoration::Private::updateCause(const QObject *sender, int signalIndex)
+{
+    if (!sender || signalIndex < 0) {
+        return QByteArrayLiteral("update");
+    }
+    return sender->metaObject()->method(signalIndex).name();
+}
+
+void Decoration::Private::requestUpdate(const QRect &rect, const QByteArray &cause, DecorationButton *button)
+{
+    // the client area is never painted by the Decoration, unless there is no frame yet,
+    // e.g. before init sets the borders
+    QRegion frame = q->frameRegion();
+    if (frame.isEmpty()) {
+        frame = q->rect();
+    }
+    const QRegion region = frame & (rect.isNull() ? q->rect() : rect);
+    if (repaintStatistics) {
+        recordRequest(*repaintStatistics, region, cause);
+        if (button) {
+            recordRequest(buttonRepaintStatistics[button], region, cause);
+        }
+        if (!region.isEmpty() && !synchronousUpdates && !pendingDamage.isEmpty()) {
+            repaintStatistics->coalescedRequests++;
+        }
+    }
+    addDamage(region);
+}
+
+void Decoration::Private::addDamage(const QRegion &region)
+{
+    if (region.isEmpty()) {
+        return;
+    }
+    if (synchronousUpdates) {
+        if (repaintStatistics) {
+            repaintStatistics->flushes++;
+        }
+        for (const QRect &rect : region) {
+            deliverDamage(rect);
         }
         return;
     }
-    setSectionUnderMouse(Qt::NoSection);
+    pendingDamage += region;
+    if (!damageFlushScheduled) {
+        damageFlushScheduled = true;
+        QMetaObject::invokeMethod(q, [this] { flushDamage(); }, Qt::QueuedConnection);
+    }
+}
+
+void Decoration::Private::scheduleToolTip(bool visible, const QString &text)
+{
+    pendingToolTipVisible = visible;
+    pendingToolTip = text;
+    if (toolTipDelay <= 0) {
+        flushToolTip();
+        return;
+    }
+    if (!toolTipTimer) {
+        toolTipTimer = new QTimer(q);
+        toolTipTimer->setSingleShot(true);
+        QObject::connect(toolTipTimer, &QTimer::timeout, q, [this] { flushToolTip(); });
+    }
+    toolTipTimer->start(toolTipDelay);
+}
+
+void Decoration::Private::flushToolTip()
+{
+    if (toolTipTimer) {
+        toolTipTimer->stop();
+    }
+    if (pendingToolTipVisible) {
+        if (toolTipVisible && toolTip == pendingToolTip) {
+            return;
+        }
+        toolTipVisible = true;
+        toolTip = pendingToolTip;
+        client->d->requestShowToolTip(toolTip);
+    } else if (toolTipVisible) {
+        toolTipVisible = false;
+        toolTip.clear();
+        client->d->requestHideToolTip();
+    }
+}
+
+void Decoration::Private::flushDamage()
+{
+    damageFlushScheduled = false;
+    if (pendingDamage.isEmpty()) {
+        return;
+    }
+    const QRegion damage = pendingDamage;
+    pendingDamage = QRegion();
+    if (repaintStatistics) {
+        repaintStatistics->flushes++;
+    }
+    const QRect bounds = damage.boundingRect();
+    if (damage.rectCount() == 1) {
+        deliverDamage(bounds);
+        return;
+    }
+    // prefer a single repaint unless the rects are far apart
+    if (area(bounds) <= 2 * area(damage)) {
+        deliverDamage(bounds);
+        return;
+    }
+    for (const QRect &rect : damage) {
+        deliverDamage(rect);
+    }
+}
+
+void Decoration::Private::deliverDamage(const QRect &rect)
+{
+    if (repaintStatistics) {
+        const quint64 rectArea = area(rect);
+        repaintStatistics->flushedRects++;
+        repaintStatistics->flushedArea += rectArea;
+        int bucket = 0;
+        for (quint64 a = rectArea; a > 1; a >>= 1) {
+            bucket++;
+        }
+        if (repaintStatistics->flushedAreaHistogram.count() <= bucket) {
+            repaintStatistics->flushedAreaHistogram.resize(bucket + 1);
+        }
+        repaintStatistics->flushedAreaHistogram[bucket]++;
+    }
+    bridge->update(q, rect);
+}
+
+void Decoration::Private::publishSnapshot()
+{
+    auto record = new DecorationSnapshot;
+    record->borders = borders;
+    record->resizeOnlyBorders = resizeOnlyBorders;
+    record->titleBar = titleBar;
+    record->size = q->size();
+    record->opaque = opaque;
+    record->shadow = shadow;
+    const DecorationSnapshot *previous = snapshot.current();
+    record->serial = previous ? previous->serial : 0;
+    if (!previous ||
+            previous->borders != record->borders ||
+            previous->resizeOnlyBorders != record->resizeOnlyBorders ||
+            previous->titleBar != record->titleBar ||
+            previous->size != record->size ||
+            previous->opaque != record->opaque) {
+        record->serial++;
+    }
+    snapshot.publish(record);
+}
+
+DecorationSnapshot Decoration::Private::readSnapshot() const
+{
+    return snapshot.load();
 }
 
 void Decoration::Private::addButton(DecorationButton *button)
 {
     Q_ASSERT(!buttons.contains(button));
     buttons << button;
+    buttonIndexValid = false;
     QObject::connect(button, &QObject::destroyed, q,
         [this](QObject *o) {
             auto it = buttons.begin();
@@ -125,18 +366,130 @@ void Decoration::Private::addButton(DecorationButton *button)
                     it++;
                 }
             }
+            hoveredButtons.removeAll(static_cast<DecorationButton*>(o));
+            buttonRepaintStatistics.remove(static_cast<DecorationButton*>(o));
+            if (pointerGrab == o) {
+                pointerGrab = nullptr;
+            }
+            buttonIndexValid = false;
+        }
+    );
+    auto invalidateIndex = [this] { buttonIndexValid = false; };
+    QObject::connect(button, &DecorationButton::geometryChanged, q, invalidateIndex);
+    QObject::connect(button, &DecorationButton::visibilityChanged, q, invalidateIndex);
+    QObject::connect(button, &DecorationButton::enabledChanged, q, invalidateIndex);
+    QObject::connect(button, &DecorationButton::hoveredChanged, q,
+        [this, button](bool hovered) {
+            if (!hovered) {
+                hoveredButtons.removeOne(button);
+            } else if (!hoveredButtons.contains(button)) {
+                hoveredButtons << button;
+            }
         }
     );
+    // disabling or hiding a button releases it and thus ends the grab as well
+    QObject::connect(button, &DecorationButton::pressedChanged, q,
+        [this, button](bool pressed) {
+            if (pressed) {
+                pointerGrab = button;
+            } else if (pointerGrab == button) {
+                pointerGrab = nullptr;
+            }
+        }
+    );
+}
+
+void Decoration::Private::updateButtonIndex()
+{
+    buttonIndex.clear();
+    for (DecorationButton *button : qAsConst(buttons)) {
+        if (!button->isEnabled() || !button->isVisible()) {
+            continue;
+        }
+        // same rounding as DecorationButton::contains
+        buttonIndex.append({button->geometry().toRect().normalized(), 0, button});
+    }
+    std::sort(buttonIndex.begin(), buttonIndex.end(),
+        [](const IndexedButton &a, const IndexedButton &b) {
+            return a.geometry.left() < b.geometry.left();
+        }
+    );
+    int maxRight = std::numeric_limits<int>::min();
+    for (IndexedButton &entry : buttonIndex) {
+        maxRight = qMax(maxRight, entry.geometry.right());
+        entry.maxRight = maxRight;
+    }
+    buttonIndexValid = true;
+}
+
+void Decoration::Private::buttonsAt(const QPoint &pos, QVarLengthArray<DecorationButton*, 4> &result)
+{
+    if (!buttonIndexValid) {
+        updateButtonIndex();
+    }
+    // first entry starting right of pos, everything before it might contain pos
+    auto it = std::upper_bound(buttonIndex.constBegin(), buttonIndex.constEnd(), pos.x(),
+        [](int x, const IndexedButton &entry) {
+            return x < entry.geometry.left();
+        }
+    );
+    while (it != buttonIndex.constBegin()) {
+        --it;
+        if (it->maxRight < pos.x()) {
+            // no remaining entry reaches pos
+            break;
+        }
+        if (it->geometry.contains(pos)) {
+            result.append(it->button);
+        }
+    }
 }
 
 Decoration::Decoration(QObject *parent, const QVariantList &args)
     : QObject(parent)
     , d(new Private(this, args))
 {
+    // connected first to have the snapshot up to date for all other receivers
+    auto publishSnapshot = [this] { d->publishSnapshot(); };
+    d->publishSnapshot();
+    connect(this, &Decoration::bordersChanged, this, publishSnapshot);
+    connect(this, &Decoration::resizeOnlyBordersChanged, this, publishSnapshot);
+    connect(this, &Decoration::titleBarChanged, this, publishSnapshot);
+    connect(this, &Decoration::opaqueChanged, this, publishSnapshot);
+    connect(this, &Decoration::shadowChanged, this, publishSnapshot);
+    // a resize of the client reported as a batch is published once
+    const DecoratedClient::StateChanges geometryChanges = DecoratedClient::StateChange::Width |
+        DecoratedClient::StateChange::Height | DecoratedClient::StateChange::Size | DecoratedClient::StateChange::Shaded;
+    connect(d->client.data(), &DecoratedClient::stateChanged, this,
+        [this, geometryChanges](DecoratedClient::StateChanges changes) {
+            if (changes & geometryChanges) {
+                d->publishSnapshot();
+            }
+        }
+    );
+
     connect(this, &Decoration::bordersChanged, this, [this]{ update(); });
+
+    // the section map follows each change right away, input can be delivered during a batch
+    auto invalidateSections = [this] { d->invalidateSectionMap(); };
+    connect(this, &Decoration::bordersChanged, this, invalidateSections);
+    connect(this, &Decoration::titleBarChanged, this, invalidateSections);
+    DecoratedClient *client = d->client.data();
+    connect(client, &DecoratedClient::widthChanged, this, invalidateSections);
+    connect(client, &DecoratedClient::heightChanged, this, invalidateSections);
+    connect(client, &DecoratedClient::sizeChanged, this, invalidateSections);
+    connect(client, &DecoratedClient::shadedChanged, this, invalidateSections);
 }
 
-Decoration::~Decoration() = default;
+Decoration::~Decoration()
+{
+    if (d->repaintStatistics && KDECORATION2_REPAINT().isDebugEnabled()) {
+        qCDebug(KDECORATION2_REPAINT) << this << *d->repaintStatistics;
+        for (DecorationButton *button : qAsConst(d->buttons)) {
+            qCDebug(KDECORATION2_REPAINT) << "    " << button << d->buttonRepaintStatistics.value(button);
+        }
+    }
+}
 
 void Decoration::init()
 {
@@ -167,12 +520,12 @@ DELEGATE(requestShowWindowMenu)
 
 void Decoration::requestShowToolTip(const QString &text)
 {
-    d->client->d->requestShowToolTip(text);
+    d->scheduleToolTip(true, text);
 }
 
 void Decoration::requestHideToolTip()
 {
-    d->client->d->requestHideToolTip();
+    d->scheduleToolTip(false, QString());
 }
 
 void Decoration::requestToggleMaximization(Qt::MouseButtons buttons)
@@ -258,11 +611,46 @@ QSize Decoration::size() const
                  (d->client->isShaded() ? 0 : d->client->height()) + b.top() + b.bottom());
 }
 
+DecorationSnapshot Decoration::snapshot() const
+{
+    return d->readSnapshot();
+}
+
 QRect Decoration::rect() const
 {
     return QRect(QPoint(0, 0), size());
 }
 
+QRect Decoration::framePartGeometry(Qt::Edge edge) const
+{
+    const QRect r = rect();
+    const QMargins &b = d->borders;
+    const int sideHeight = qMax(0, r.height() - b.top() - b.bottom());
+    switch (edge) {
+    case Qt::TopEdge:
+        return QRect(0, 0, r.width(), b.top());
+    case Qt::LeftEdge:
+        return QRect(0, b.top(), b.left(), sideHeight);
+    case Qt::RightEdge:
+        return QRect(r.width() - b.right(), b.top(), b.right(), sideHeight);
+    case Qt::BottomEdge:
+        return QRect(0, r.height() - b.bottom(), r.width(), b.bottom());
+    }
+    return QRect();
+}
+
+QRegion Decoration::frameRegion() const
+{
+    QRegion region;
+    for (Qt::Edge edge : {Qt::TopEdge, Qt::LeftEdge, Qt::RightEdge, Qt::BottomEdge}) {
+        const QRect part = framePartGeometry(edge);
+        if (!part.isEmpty()) {
+            region += part;
+        }
+    }
+    return region;
+}
+
 bool Decoration::event(QEvent *event)
 {
     switch (event->type()) {
@@ -310,56 +698,70 @@ void Decoration::hoverLeaveEvent(QHoverEvent *event)
 
 void Decoration::hoverMoveEvent(QHoverEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
+    QVarLengthArray<DecorationButton*, 4> underMouse;
+    d->buttonsAt(event->pos(), underMouse);
+    // copy as leave events modify the hovered buttons
+    const QVector<DecorationButton*> hoveredButtons = d->hoveredButtons;
+    for (DecorationButton *button : hoveredButtons) {
         if (!button->isEnabled() || !button->isVisible()) {
             continue;
         }
-        const bool hovered = button->isHovered();
-        const bool contains = button->contains(event->posF());
-        if (!hovered && contains) {
-            QHoverEvent e(QEvent::HoverEnter, event->posF(), event->oldPosF(), event->modifiers());
-            QCoreApplication::instance()->sendEvent(button, &e);
-        } else if (hovered && !contains) {
+        if (std::find(underMouse.constBegin(), underMouse.constEnd(), button) == underMouse.constEnd()) {
             QHoverEvent e(QEvent::HoverLeave, event->posF(), event->oldPosF(), event->modifiers());
             QCoreApplication::instance()->sendEvent(button, &e);
-        } else if (hovered && contains) {
+        } else {
             QCoreApplication::instance()->sendEvent(button, event);
         }
     }
+    for (DecorationButton *button : qAsConst(underMouse)) {
+        if (!button->isHovered()) {
+            QHoverEvent e(QEvent::HoverEnter, event->posF(), event->oldPosF(), event->modifiers());
+            QCoreApplication::instance()->sendEvent(button, &e);
+        }
+    }
     d->updateSectionUnderMouse(event->pos());
 }
 
 void Decoration::mouseMoveEvent(QMouseEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        if (button->isPressed()) {
-            QCoreApplication::instance()->sendEvent(button, event);
-            return;
-        }
+    if (DecorationButton *button = d->pointerGrab) {
+        QCoreApplication::instance()->sendEvent(button, event);
+        return;
     }
     // not handled, take care ourselves
 }
 
 void Decoration::mousePressEvent(QMouseEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        if (button->isHovered()) {
-            if (button->acceptedButtons().testFlag(event->button())) {
-                QCoreApplication::instance()->sendEvent(button, event);
+    // further presses while a button is pressed go to that button
+    DecorationButton *button = d->pointerGrab;
+    if (!button) {
+        if (d->hoveredButtons.isEmpty()) {
+            return;
+        }
+        // overlapping buttons are resolved by the order of the buttons, not of hovering
+        auto it = std::find_if(d->buttons.constBegin(), d->buttons.constEnd(),
+            [](DecorationButton *b) {
+                return b->isHovered();
             }
-            event->setAccepted(true);
+        );
+        if (it == d->buttons.constEnd()) {
             return;
         }
+        button = *it;
     }
+    if (button->acceptedButtons().testFlag(event->button())) {
+        QCoreApplication::instance()->sendEvent(button, event);
+    }
+    event->setAccepted(true);
 }
 
 void Decoration::mouseReleaseEvent(QMouseEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        if (button->isPressed() && button->acceptedButtons().testFlag(event->button())) {
-            QCoreApplication::instance()->sendEvent(button, event);
-            return;
-        }
+    DecorationButton *button = d->pointerGrab;
+    if (button && button->acceptedButtons().testFlag(event->button())) {
+        QCoreApplication::instance()->sendEvent(button, event);
+        return;
     }
     // not handled, take care ourselves
     d->updateSectionUnderMouse(event->pos());
@@ -377,7 +779,11 @@ void Decoration::wheelEvent(QWheelEvent *event)
 
 void Decoration::update(const QRect &r)
 {
-    d->bridge->update(this, r.isNull() ? rect() : r);
+    QByteArray cause;
+    if (d->repaintStatistics) {
+        cause = Private::updateCause(sender(), senderSignalIndex());
+    }
+    d->requestUpdate(r, cause, nullptr);
 }
 
 void Decoration::update()
@@ -387,7 +793,64 @@ void Decoration::update()
 
 void Decoration::setSettings(const QSharedPointer< DecorationSettings > &settings)
 {
+    disconnect(d->settingsSpacingConnection);
     d->settings = settings;
+    d->invalidateSectionMap();
+    if (settings) {
+        d->settingsSpacingConnection = connect(settings.data(), &DecorationSettings::spacingChanged, this,
+            [this] {
+                d->invalidateSectionMap();
+            }
+        );
+    }
+}
+
+void Decoration::setSynchronousUpdates(bool synchronous)
+{
+    d->synchronousUpdates = synchronous;
+    if (synchronous) {
+        d->flushDamage();
+    }
+}
+
+void Decoration::setToolTipDelay(int msec)
+{
+    d->toolTipDelay = qMax(0, msec);
+    if (d->toolTipDelay == 0 && d->toolTipTimer && d->toolTipTimer->isActive()) {
+        d->flushToolTip();
+    }
+}
+
+int Decoration::toolTipDelay() const
+{
+    return d->toolTipDelay;
+}
+
+void Decoration::setRepaintStatisticsEnabled(bool enabled)
+{
+    if (enabled == isRepaintStatisticsEnabled()) {
+        return;
+    }
+    d->repaintStatistics.reset(enabled ? new DecorationRepaintStatistics : nullptr);
+    d->buttonRepaintStatistics.clear();
+}
+
+bool Decoration::isRepaintStatisticsEnabled() const
+{
+    return !d->repaintStatistics.isNull();
+}
+
+DecorationRepaintStatistics Decoration::repaintStatistics() const
+{
+    return d->repaintStatistics ? *d->repaintStatistics : DecorationRepaintStatistics();
+}
+
+void Decoration::resetRepaintStatistics()
+{
+    if (d->repaintStatistics) {
+        *d->repaintStatistics = DecorationRepaintStatistics();
+    }
+    d->buttonRepaintStatistics.clear();
 }
 
 QSharedPointer< DecorationSettings > Decoration::settings() const
@@ -7,12 +7,14 @@
 #define KDECORATION2_DECORATION_H
 
 #include <kdecoration2/kdecoration2_export.h>
+#include "decorationrepaintstatistics.h"
 #include "decorationshadow.h"
 
 #include <QMargins>
 #include <QObject>
 #include <QPointer>
 #include <QRect>
+#include <QRegion>
 
 class QHoverEvent;
 class QMouseEvent;
@@ -31,6 +33,28 @@ class DecoratedClient;
 class DecorationButton;
 class DecorationSettings;
 
+/**
+ * @brief The geometry related state of a Decoration at one point in time.
+ *
+ * Obtained through Decoration::snapshot, which can be called from any thread.
+ * @since 5.21
+ **/
+struct DecorationSnapshot
+{
+    QMargins borders;
+    QMargins resizeOnlyBorders;
+    QRect titleBar;
+    QSize size;
+    bool opaque = false;
+    QSharedPointer<DecorationShadow> shadow;
+    /**
+     * Incremented whenever one of the geometry values changes. Comparing it with the serial
+     * of a previous snapshot tells whether the geometry values need to be looked at again.
+     * Changes of the shadow do not increment it.
+     **/
+    quint64 serial = 0;
+};
+
 /**
  * @brief Base class for the Decoration.
  *
@@ -128,6 +152,41 @@ public:
     QRect rect() const;
     QSize size() const;
 
+    /**
+     * The geometry of the part of the frame at @p edge in local coordinates, computed from
+     * rect and borders. The Qt::TopEdge part spans the complete width and contains the title
+     * bar, as does the Qt::BottomEdge part. The Qt::LeftEdge and Qt::RightEdge parts are
+     * the borders between them. Parts without a border are empty.
+     *
+     * @see frameRegion
+     * @since 5.21
+     **/
+    QRect framePartGeometry(Qt::Edge edge) const;
+    /**
+     * The area of rect covered by the frame, that is everything except the client area.
+     * Repaint requests through update are restricted to this area unless it is empty.
+     *
+     * @see framePartGeometry
+     * @since 5.21
+     **/
+    QRegion frameRegion() const;
+
+    /**
+     * The borders, resize only borders, title bar, size, opaqueness and shadow of this
+     * Decoration as a consistent snapshot.
+     *
+     * In contrast to all other methods this method may be called from any thread, e.g. the
+     * render thread of a compositor, as long as the Decoration is not destroyed meanwhile.
+     * The thread of the Decoration publishes an immutable copy of the values whenever one of
+     * them changes and swaps it in atomically. Reading copies the current one without locking,
+     * so readers never block the thread of the Decoration. Readers only wait for each other
+     * if more than 16 of them read at the same time. A resize of the DecoratedClient reported
+     * as one DecoratedClient::stateChanged is published once the change batch ends.
+     *
+     * @since 5.21
+     **/
+    DecorationSnapshot snapshot() const;
+
     /**
      * Invoked by the framework to set the Settings for this Decoration before
      * init is invoked.
@@ -138,6 +197,57 @@ public:
      * @returns The DecorationSettings used for this Decoration.
      **/
     QSharedPointer<DecorationSettings> settings() const;
+    /**
+     * By default the areas passed to update are collected and handed to the framework once
+     * control returns to the event loop, so that overlapping requests issued while handling
+     * one event result in a single repaint. If @p synchronous is @c true each request is
+     * forwarded immediately. This is mostly useful for tests.
+     * @internal
+     * @since 5.21
+     **/
+    void setSynchronousUpdates(bool synchronous);
+    /**
+     * Tooltip requests are collected for @p msec milliseconds and only the last one is
+     * forwarded to the framework, so that moving the pointer over several buttons results in
+     * a single tooltip for the button the pointer stops on. A delay of @c 0 forwards each
+     * request immediately. Default is @c 0.
+     * @see requestShowToolTip
+     * @see requestHideToolTip
+     * @since 5.21
+     **/
+    void setToolTipDelay(int msec);
+    /**
+     * @returns The time in milliseconds tooltip requests are collected.
+     * @see setToolTipDelay
+     * @since 5.21
+     **/
+    int toolTipDelay() const;
+
+    /**
+     * Enables or disables collecting DecorationRepaintStatistics for this Decoration and its
+     * buttons. Disabling discards the collected statistics. Collecting is enabled by default
+     * if debug output of the logging category @c kdecoration.repaint is enabled.
+     * @see repaintStatistics
+     * @since 5.21
+     **/
+    void setRepaintStatisticsEnabled(bool enabled);
+    /**
+     * @returns Whether DecorationRepaintStatistics are collected for this Decoration.
+     * @since 5.21
+     **/
+    bool isRepaintStatisticsEnabled() const;
+    /**
+     * @returns The repaint statistics collected since they got enabled or last reset,
+     * default constructed statistics if collecting is disabled.
+     * @see DecorationButton::repaintStatistics
+     * @since 5.21
+     **/
+    DecorationRepaintStatistics repaintStatistics() const;
+    /**
+     * Resets the repaint statistics of this Decoration and its buttons.
+     * @since 5.21
+     **/
+    void resetRepaintStatistics();
 
     /**
      * Implement this method in inheriting classes to provide the rendering.
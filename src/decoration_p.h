@@ -6,6 +6,15 @@
 #ifndef KDECORATION2_DECORATION_P_H
 #define KDECORATION2_DECORATION_P_H
 #include "decoration.h"
+#include "atomicsnapshot_p.h"
+
+#include <QHash>
+#include <QRegion>
+#include <QString>
+#include <QVarLengthArray>
+#include <QVector>
+
+#include <atomic>
 
 //
 //  W A R N I N G
@@ -18,6 +27,8 @@
 // We mean it.
 //
 
+class QTimer;
+
 namespace KDecoration2
 {
 
@@ -32,6 +43,7 @@ class Q_DECL_HIDDEN Decoration::Private
 {
 public:
     Private(Decoration *decoration, const QVariantList &args);
+    ~Private();
 
     QMargins borders;
     QMargins resizeOnlyBorders;
@@ -39,19 +51,93 @@ public:
     Qt::WindowFrameSection sectionUnderMouse;
     void setSectionUnderMouse(Qt::WindowFrameSection section);
     void updateSectionUnderMouse(const QPoint &mousePosition);
+    void invalidateSectionMap();
 
     QRect titleBar;
 
+    /**
+     * Clips @p rect to the frame and adds it to the damage. @p cause and @p button are only
+     * used for the repaint statistics.
+     **/
+    void requestUpdate(const QRect &rect, const QByteArray &cause, DecorationButton *button);
+    void addDamage(const QRegion &region);
+    void flushDamage();
+    void deliverDamage(const QRect &rect);
+    /**
+     * The name of the signal of @p sender with @p signalIndex, or @c update if there is no sender.
+     **/
+    static QByteArray updateCause(const QObject *sender, int signalIndex);
+
+    /**
+     * Publishes a new record with the values returned by Decoration::snapshot for readers on
+     * other threads. Must be called from the thread of the Decoration whenever one of the
+     * values changes.
+     **/
+    void publishSnapshot();
+    DecorationSnapshot readSnapshot() const;
+
     void addButton(DecorationButton *button);
+    /**
+     * Collects all enabled and visible buttons containing @p pos, uses the button index.
+     **/
+    void buttonsAt(const QPoint &pos, QVarLengthArray<DecorationButton*, 4> &result);
 
     QSharedPointer<DecorationSettings> settings;
+    QMetaObject::Connection settingsSpacingConnection;
     DecorationBridge *bridge;
     QSharedPointer<DecoratedClient> client;
     bool opaque;
     QVector<DecorationButton*> buttons;
+    QVector<DecorationButton*> hoveredButtons;
+    // the pressed button, receives all mouse events till it is no longer pressed
+    DecorationButton *pointerGrab = nullptr;
     QSharedPointer<DecorationShadow> shadow;
+    // damage collected until control returns to the event loop
+    QRegion pendingDamage;
+    bool damageFlushScheduled = false;
+    bool synchronousUpdates = false;
+
+    /**
+     * Remembers the tooltip request and forwards the last one to the client once no further
+     * request arrived for toolTipDelay milliseconds, so that moving the pointer across several
+     * buttons does not show and hide a tooltip for each of them.
+     **/
+    void scheduleToolTip(bool visible, const QString &text);
+    void flushToolTip();
+    QTimer *toolTipTimer = nullptr;
+    int toolTipDelay = 0;
+    QString pendingToolTip;
+    bool pendingToolTipVisible = false;
+    // the tooltip as last forwarded to the client
+    QString toolTip;
+    bool toolTipVisible = false;
+    // only allocated while collecting repaint statistics
+    QScopedPointer<DecorationRepaintStatistics> repaintStatistics;
+    QHash<const DecorationButton*, DecorationRepaintStatistics> buttonRepaintStatistics;
 
 private:
+    Qt::WindowFrameSection sectionAt(const QPoint &pos, const QSize &size, int corner) const;
+    void updateSectionMap();
+    // sorted coordinates at which the result of sectionAt may change
+    QVector<int> sectionXBands;
+    QVector<int> sectionYBands;
+    // section for each x band/y band combination
+    QVector<Qt::WindowFrameSection> sectionMap;
+    bool sectionMapValid = false;
+
+    struct IndexedButton {
+        QRect geometry;
+        // largest right edge of this and all preceding entries
+        int maxRight;
+        DecorationButton *button;
+    };
+    void updateButtonIndex();
+    // enabled and visible buttons sorted by the left edge of their geometry
+    QVector<IndexedButton> buttonIndex;
+    bool buttonIndexValid = false;
+
+    // immutable record returned by Decoration::snapshot, replaced as a whole by publishSnapshot
+    AtomicSnapshot<DecorationSnapshot> snapshot;
     Decoration *q;
 };
 
@@ -0,0 +1,243 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationatlas.h"
+#include "decoration.h"
+
+#include <QHash>
+#include <QPainter>
+#include <QtMath>
+
+namespace KDecoration2
+{
+
+namespace {
+// gap between two parts so that sampling at the edge of a part does not pick up its neighbour
+const int s_partSpacing = 1;
+}
+
+class Q_DECL_HIDDEN DecorationAtlas::Private
+{
+public:
+    explicit Private(const QSize &size, Mode mode, qreal devicePixelRatio);
+
+    QRect allocate(const QSize &size);
+    void release(const QRect &rect);
+    void renderPart(Decoration *decoration, const Part &part, const QRect &repaintArea);
+
+    struct Shelf {
+        int y;
+        int height;
+        // x position of the next allocation
+        int x;
+        // number of parts placed on this shelf
+        int allocations;
+    };
+
+    Mode mode;
+    qreal devicePixelRatio;
+    QImage image;
+    QRegion damage;
+    QVector<Shelf> shelves;
+    QHash<Decoration*, QVector<Part>> parts;
+};
+
+DecorationAtlas::Private::Private(const QSize &size, Mode mode, qreal devicePixelRatio)
+    : mode(mode)
+    , devicePixelRatio(devicePixelRatio)
+    , image(size, QImage::Format_ARGB32_Premultiplied)
+{
+    image.fill(Qt::transparent);
+}
+
+QRect DecorationAtlas::Private::allocate(const QSize &size)
+{
+    const int width = size.width() + s_partSpacing;
+    const int height = size.height() + s_partSpacing;
+    if (width > image.width()) {
+        return QRect();
+    }
+    // prefer the lowest shelf the part fits into to keep the waste small
+    Shelf *best = nullptr;
+    for (Shelf &shelf : shelves) {
+        if (shelf.height < height) {
+            continue;
+        }
+        if (shelf.allocations == 0) {
+            // the shelf got emptied, all of its space can be reused
+            shelf.x = 0;
+        }
+        if (image.width() - shelf.x < width) {
+            continue;
+        }
+        if (!best || shelf.height < best->height) {
+            best = &shelf;
+        }
+    }
+    if (!best || best->height > height * 2) {
+        // open a new shelf unless the part is the only way to use an existing one
+        const int y = shelves.isEmpty() ? 0 : shelves.last().y + shelves.last().height;
+        if (y + height <= image.height()) {
+            shelves.append({y, height, 0, 0});
+            best = &shelves.last();
+        }
+    }
+    if (!best) {
+        return QRect();
+    }
+    const QRect rect(best->x, best->y, size.width(), size.height());
+    best->x += width;
+    best->allocations++;
+    return rect;
+}
+
+void DecorationAtlas::Private::release(const QRect &rect)
+{
+    for (int i = 0; i < shelves.count(); ++i) {
+        Shelf &shelf = shelves[i];
+        if (rect.y() != shelf.y) {
+            continue;
+        }
+        shelf.allocations--;
+        if (shelf.allocations == 0) {
+            shelf.x = 0;
+            // empty shelves at the end are removed to allow a new shelf of different height
+            while (!shelves.isEmpty() && shelves.last().allocations == 0) {
+                shelves.removeLast();
+            }
+        }
+        break;
+    }
+}
+
+void DecorationAtlas::Private::renderPart(Decoration *decoration, const Part &part, const QRect &repaintArea)
+{
+    const QRect area = repaintArea.isNull() ? part.geometry : (repaintArea & part.geometry);
+    if (area.isEmpty()) {
+        return;
+    }
+    QPainter painter(&image);
+    painter.setClipRect(part.atlasRect);
+    painter.translate(part.atlasRect.topLeft());
+    painter.scale(devicePixelRatio, devicePixelRatio);
+    painter.translate(-part.geometry.topLeft());
+    painter.setClipRect(area, Qt::IntersectClip);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(area, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setRenderHint(QPainter::Antialiasing);
+    // mapped before painting, paint may leave the painter with a different transform
+    damage += painter.transform().mapRect(area) & part.atlasRect;
+    decoration->paint(&painter, area);
+}
+
+DecorationAtlas::DecorationAtlas(const QSize &size, Mode mode, qreal devicePixelRatio)
+    : d(new Private(size, mode, devicePixelRatio))
+{
+}
+
+DecorationAtlas::~DecorationAtlas() = default;
+
+DecorationAtlas::Mode DecorationAtlas::mode() const
+{
+    return d->mode;
+}
+
+QSize DecorationAtlas::size() const
+{
+    return d->image.size();
+}
+
+qreal DecorationAtlas::devicePixelRatio() const
+{
+    return d->devicePixelRatio;
+}
+
+bool DecorationAtlas::addDecoration(Decoration *decoration)
+{
+    removeDecoration(decoration);
+    QVector<Qt::Edge> edges{Qt::TopEdge};
+    if (d->mode == Mode::AllParts) {
+        edges << Qt::LeftEdge << Qt::RightEdge << Qt::BottomEdge;
+    }
+    QVector<Part> parts;
+    for (Qt::Edge edge : qAsConst(edges)) {
+        Part part{edge, decoration->framePartGeometry(edge), QRect()};
+        if (part.geometry.isEmpty()) {
+            continue;
+        }
+        part.atlasRect = d->allocate(QSize(qCeil(part.geometry.width() * d->devicePixelRatio),
+                                           qCeil(part.geometry.height() * d->devicePixelRatio)));
+        if (part.atlasRect.isNull()) {
+            for (const Part &allocated : qAsConst(parts)) {
+                d->release(allocated.atlasRect);
+            }
+            return false;
+        }
+        parts << part;
+    }
+    d->parts.insert(decoration, parts);
+    return true;
+}
+
+void DecorationAtlas::removeDecoration(Decoration *decoration)
+{
+    auto it = d->parts.find(decoration);
+    if (it == d->parts.end()) {
+        return;
+    }
+    // release in reverse order so that trailing shelves get removed
+    for (auto part = it->crbegin(); part != it->crend(); ++part) {
+        d->release(part->atlasRect);
+    }
+    d->parts.erase(it);
+}
+
+bool DecorationAtlas::contains(Decoration *decoration) const
+{
+    return d->parts.contains(decoration);
+}
+
+QVector<DecorationAtlas::Part> DecorationAtlas::parts(Decoration *decoration) const
+{
+    return d->parts.value(decoration);
+}
+
+void DecorationAtlas::render(Decoration *decoration, const QRect &repaintArea)
+{
+    auto it = d->parts.constFind(decoration);
+    if (it == d->parts.constEnd()) {
+        return;
+    }
+    for (const Part &part : *it) {
+        d->renderPart(decoration, part, repaintArea);
+    }
+}
+
+void DecorationAtlas::render()
+{
+    for (auto it = d->parts.constBegin(); it != d->parts.constEnd(); ++it) {
+        for (const Part &part : *it) {
+            d->renderPart(it.key(), part, QRect());
+        }
+    }
+}
+
+const QImage &DecorationAtlas::image() const
+{
+    return d->image;
+}
+
+QRegion DecorationAtlas::damage() const
+{
+    return d->damage;
+}
+
+void DecorationAtlas::clearDamage()
+{
+    d->damage = QRegion();
+}
+
+}
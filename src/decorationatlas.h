@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_ATLAS_H
+#define KDECORATION2_DECORATION_ATLAS_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QImage>
+#include <QRect>
+#include <QRegion>
+#include <QScopedPointer>
+#include <QVector>
+
+namespace KDecoration2
+{
+
+class Decoration;
+
+/**
+ * @brief Packs the frames of many Decorations into one shared QImage.
+ *
+ * Instead of one buffer per Decoration covering the whole window including the client area,
+ * the DecorationAtlas stores only the parts of the frame of each Decoration: the top part
+ * containing the title bar and the left, right and bottom borders, or only the top part. The
+ * parts of all added Decorations are placed into one image using a shelf allocator, so that
+ * a compositor can upload one image per frame.
+ *
+ * The DecorationAtlas does not track the Decorations. After a Decoration changed its size or
+ * borders it has to be added again, and it has to be removed before it gets destroyed. Space
+ * of removed parts is reused once all parts on the same shelf of the atlas are removed.
+ *
+ * @code
+ * DecorationAtlas atlas(QSize(2048, 2048), DecorationAtlas::Mode::AllParts, 2.0);
+ * atlas.addDecoration(decoration);
+ * atlas.render(decoration);
+ * upload(atlas.image(), atlas.damage());
+ * atlas.clearDamage();
+ * for (const auto &part : atlas.parts(decoration)) {
+ *     drawQuad(part.geometry, part.atlasRect);
+ * }
+ * @endcode
+ *
+ * The DecorationAtlas may only be used from the thread the Decorations live in.
+ * @since 5.21
+ **/
+class KDECORATIONS2_EXPORT DecorationAtlas
+{
+public:
+    enum class Mode {
+        /**
+         * The top part including the title bar and the left, right and bottom borders
+         * are stored.
+         **/
+        AllParts,
+        /**
+         * Only the top part including the title bar is stored.
+         **/
+        TitleBarOnly
+    };
+    /**
+     * The placement of one part of the frame of a Decoration in the atlas.
+     **/
+    struct Part {
+        /**
+         * The side of the frame, Qt::TopEdge is the part containing the title bar.
+         **/
+        Qt::Edge edge;
+        /**
+         * The geometry of the part in Decoration coordinates.
+         **/
+        QRect geometry;
+        /**
+         * The area of the part in the atlas image in device pixels.
+         **/
+        QRect atlasRect;
+    };
+
+    /**
+     * Creates a DecorationAtlas with an image of @p size device pixels storing the parts
+     * selected by @p mode rendered with @p devicePixelRatio.
+     **/
+    explicit DecorationAtlas(const QSize &size, Mode mode = Mode::AllParts, qreal devicePixelRatio = 1.0);
+    ~DecorationAtlas();
+
+    Mode mode() const;
+    QSize size() const;
+    qreal devicePixelRatio() const;
+
+    /**
+     * Allocates the space for the parts of @p decoration. If the @p decoration was already
+     * added before, its previous space is released first. Its parts need to be rendered
+     * again afterwards.
+     *
+     * @returns @c false if the parts do not fit into the atlas, the @p decoration is not
+     * added in that case.
+     **/
+    bool addDecoration(Decoration *decoration);
+    /**
+     * Releases the space of the parts of @p decoration.
+     **/
+    void removeDecoration(Decoration *decoration);
+    /**
+     * @returns Whether @p decoration was added to the atlas
+     **/
+    bool contains(Decoration *decoration) const;
+    /**
+     * @returns The parts of @p decoration stored in the atlas, empty if @p decoration was
+     * not added.
+     **/
+    QVector<Part> parts(Decoration *decoration) const;
+
+    /**
+     * Renders the parts of @p decoration into the atlas image restricted to @p repaintArea
+     * in Decoration coordinates. A null @p repaintArea renders the complete parts.
+     **/
+    void render(Decoration *decoration, const QRect &repaintArea = QRect());
+    /**
+     * Renders the parts of all added Decorations into the atlas image.
+     **/
+    void render();
+
+    /**
+     * The atlas image. Areas not used by any part are transparent.
+     **/
+    const QImage &image() const;
+    /**
+     * The area of the image in device pixels changed by render since the last clearDamage.
+     **/
+    QRegion damage() const;
+    void clearDamage();
+
+private:
+    Q_DISABLE_COPY(DecorationAtlas)
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+}
+
+#endif
@@ -12,10 +12,14 @@
 
 #include <KLocalizedString>
 
+#include <QCoreApplication>
 #include <QDebug>
-#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <QStringList>
 #include <QHoverEvent>
 #include <QGuiApplication>
+#include <QPainter>
 #include <QStyleHints>
 #include <QTimer>
 
@@ -222,26 +226,20 @@ void DecorationButton::Private::startDoubleClickTimer()
     if (!doubleClickEnabled) {
         return;
     }
-    if (m_doubleClickTimer.isNull()) {
-        m_doubleClickTimer.reset(new QElapsedTimer());
-    }
-    m_doubleClickTimer->start();
+    m_doubleClickTimer.start();
 }
 
 void DecorationButton::Private::invalidateDoubleClickTimer()
 {
-    if (m_doubleClickTimer.isNull()) {
-        return;
-    }
-    m_doubleClickTimer->invalidate();
+    m_doubleClickTimer.invalidate();
 }
 
 bool DecorationButton::Private::wasDoubleClick() const
 {
-    if (m_doubleClickTimer.isNull() || !m_doubleClickTimer->isValid()) {
+    if (!m_doubleClickTimer.isValid()) {
         return false;
     }
-    return !m_doubleClickTimer->hasExpired(QGuiApplication::styleHints()->mouseDoubleClickInterval());
+    return !m_doubleClickTimer.hasExpired(QGuiApplication::styleHints()->mouseDoubleClickInterval());
 }
 
 
@@ -275,7 +273,90 @@ void DecorationButton::Private::stopPressAndHold()
     }
 }
 
-QString DecorationButton::Private::typeToString(DecorationButtonType type)
+void DecorationButton::Private::setPaintCacheEnabled(bool enabled)
+{
+    if (paintCacheEnabled == enabled) {
+        return;
+    }
+    paintCacheEnabled = enabled;
+    invalidatePaintCache();
+    for (const auto &connection : qAsConst(m_paintCacheConnections)) {
+        QObject::disconnect(connection);
+    }
+    m_paintCacheConnections.clear();
+    if (!enabled) {
+        return;
+    }
+    auto clientPtr = decoration->client().toStrongRef();
+    Q_ASSERT(clientPtr);
+    auto c = clientPtr.data();
+    m_paintCacheConnections << QObject::connect(c, &DecoratedClient::stateChanged, q,
+        [this](DecoratedClient::StateChanges changes) {
+            if (changes & (DecoratedClient::StateChange::Palette | DecoratedClient::StateChange::Icon)) {
+                invalidatePaintCache();
+            }
+        }
+    );
+    // themes commonly size and place their symbols based on the font and the spacings
+    if (auto settings = decoration->settings()) {
+        auto invalidate = [this] { invalidatePaintCache(); };
+        DecorationSettings *s = settings.data();
+        m_paintCacheConnections << QObject::connect(s, &DecorationSettings::fontChanged, q, invalidate);
+        m_paintCacheConnections << QObject::connect(s, &DecorationSettings::gridUnitChanged, q, invalidate);
+        m_paintCacheConnections << QObject::connect(s, &DecorationSettings::spacingChanged, q, invalidate);
+        m_paintCacheConnections << QObject::connect(s, &DecorationSettings::reconfigured, q, invalidate);
+    }
+}
+
+void DecorationButton::Private::invalidatePaintCache()
+{
+    m_paintCache.clear();
+}
+
+quint64 DecorationButton::Private::paintCacheKey(qreal devicePixelRatio) const
+{
+    const bool active = decoration->client().toStrongRef()->isActive();
+    const quint64 state = (hovered ? 1 : 0)
+                        | (isPressed() ? 2 : 0)
+                        | (checked ? 4 : 0)
+                        | (enabled ? 8 : 0)
+                        | (active ? 16 : 0);
+    return (quint64(qRound(devicePixelRatio * 1000)) << 8) | state;
+}
+
+void DecorationButton::Private::paintCached(QPainter *painter, const QRect &repaintArea)
+{
+    if (!paintCacheEnabled) {
+        q->paint(painter, repaintArea);
+        return;
+    }
+    const QRect area = geometry.toAlignedRect();
+    if (area.isEmpty() || !repaintArea.intersects(area)) {
+        return;
+    }
+    if (m_paintCacheSize != geometry.size()) {
+        invalidatePaintCache();
+        m_paintCacheSize = geometry.size();
+    }
+    const qreal devicePixelRatio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const quint64 key = paintCacheKey(devicePixelRatio);
+    auto it = m_paintCache.constFind(key);
+    if (it == m_paintCache.constEnd()) {
+        QImage image((geometry.size() * devicePixelRatio).toSize(), QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(devicePixelRatio);
+        image.fill(Qt::transparent);
+        QPainter p(&image);
+        p.setRenderHints(painter->renderHints());
+        p.translate(-geometry.topLeft());
+        q->paint(&p, area);
+        p.end();
+        it = m_paintCache.insert(key, image);
+    }
+    painter->drawImage(geometry.topLeft(), it.value());
+}
+
+namespace {
+QString translatedTypeToString(DecorationButtonType type, bool checked)
 {
     switch (type) {
     case DecorationButtonType::Menu:
@@ -283,14 +364,14 @@ QString DecorationButton::Private::typeToString(DecorationButtonType type)
     case DecorationButtonType::ApplicationMenu:
         return i18n("Application menu");
     case DecorationButtonType::OnAllDesktops:
-        if ( this->q->isChecked() )
+        if ( checked )
             return i18n("On one desktop");
         else
             return i18n("On all desktops");
     case DecorationButtonType::Minimize:
         return i18n("Minimize");
     case DecorationButtonType::Maximize:
-        if ( this->q->isChecked() )
+        if ( checked )
             return i18n("Restore");
         else
             return i18n("Maximize");
@@ -299,17 +380,17 @@ QString DecorationButton::Private::typeToString(DecorationButtonType type)
     case DecorationButtonType::ContextHelp:
         return i18n("Context help");
     case DecorationButtonType::Shade:
-        if ( this->q->isChecked() )
+        if ( checked )
             return i18n("Unshade");
         else
             return i18n("Shade");
     case DecorationButtonType::KeepBelow:
-        if ( this->q->isChecked() )
+        if ( checked )
             return i18n("Don't keep below");
         else
             return i18n("Keep below");
     case DecorationButtonType::KeepAbove:
-        if ( this->q->isChecked() )
+        if ( checked )
             return i18n("Don't keep above");
         else
             return i18n("Keep above");
@@ -318,6 +399,61 @@ QString DecorationButton::Private::typeToString(DecorationButtonType type)
     }
 }
 
+// translated labels shared by all buttons, dropped when the application language changes
+class ToolTipLabelCache : public QObject
+{
+public:
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (watched == QCoreApplication::instance() && event->type() == QEvent::LanguageChange) {
+            labels.clear();
+        }
+        return false;
+    }
+
+    // the filter has to be installed again on an application created after the cache
+    void watchApplication()
+    {
+        QCoreApplication *app = QCoreApplication::instance();
+        if (application == app) {
+            return;
+        }
+        application = app;
+        labels.clear();
+        if (app) {
+            app->installEventFilter(this);
+        }
+    }
+
+    QPointer<QCoreApplication> application;
+    // the languages the labels got translated to
+    QStringList languages;
+    // keyed by the button type and the checked state in the lowest bit
+    QHash<int, QString> labels;
+};
+
+Q_GLOBAL_STATIC(ToolTipLabelCache, s_toolTipLabels)
+}
+
+QString DecorationButton::Private::typeToString(DecorationButtonType type)
+{
+    s_toolTipLabels->watchApplication();
+    const bool checked = q->isChecked();
+    const int key = int(type) << 1 | int(checked);
+    QHash<int, QString> &labels = s_toolTipLabels->labels;
+    auto it = labels.constFind(key);
+    if (it == labels.constEnd()) {
+        // KLocalizedString::setLanguages does not send a QEvent::LanguageChange
+        const QStringList languages = KLocalizedString::languages();
+        if (s_toolTipLabels->languages != languages) {
+            s_toolTipLabels->languages = languages;
+            labels.clear();
+        }
+        it = labels.insert(key, translatedTypeToString(type, checked));
+    }
+    return it.value();
+}
+
 DecorationButton::DecorationButton(DecorationButtonType type, const QPointer<Decoration> &decoration, QObject *parent)
     : QObject(parent)
     , d(new Private(type, decoration, this))
@@ -326,33 +462,24 @@ DecorationButton::DecorationButton(DecorationButtonType type, const QPointer<Dec
     connect(this, &DecorationButton::geometryChanged,
             this, static_cast<void (DecorationButton::*)(const QRectF&)>(&DecorationButton::update));
     auto updateSlot = static_cast<void (DecorationButton::*)()>(&DecorationButton::update);
-    connect(this, &DecorationButton::hoveredChanged, this, updateSlot);
+    // one connection per signal handling all the internal reactions to keep the
+    // per button overhead low
     connect(this, &DecorationButton::hoveredChanged, this,
         [this](bool hovered) {
+            update();
             if (hovered) {
-                //TODO: show tooltip if hovered and hide if not
                 const QString type = this->d->typeToString(this->type());
                 this->decoration()->requestShowToolTip(type);
-            } else {
-                this->decoration()->requestHideToolTip();
-            }
-        }
-    );
-    connect(this, &DecorationButton::pressedChanged, this, updateSlot);
-    connect(this, &DecorationButton::checkedChanged, this, updateSlot);
-    connect(this, &DecorationButton::enabledChanged, this, updateSlot);
-    connect(this, &DecorationButton::visibilityChanged, this, updateSlot);
-    connect(this, &DecorationButton::hoveredChanged, this,
-        [this](bool hovered) {
-            if (hovered) {
                 emit pointerEntered();
             } else {
+                this->decoration()->requestHideToolTip();
                 emit pointerLeft();
             }
         }
     );
     connect(this, &DecorationButton::pressedChanged, this,
         [this](bool p) {
+            update();
             if (p) {
                 emit pressed();
             } else {
@@ -360,13 +487,26 @@ DecorationButton::DecorationButton(DecorationButtonType type, const QPointer<Dec
             }
         }
     );
+    connect(this, &DecorationButton::checkedChanged, this, updateSlot);
+    connect(this, &DecorationButton::enabledChanged, this, updateSlot);
+    connect(this, &DecorationButton::visibilityChanged, this, updateSlot);
 }
 
 DecorationButton::~DecorationButton() = default;
 
 void DecorationButton::update(const QRectF &rect)
 {
-    decoration()->update(rect.isNull() ? geometry().toRect() : rect.toRect());
+    Decoration *deco = decoration();
+    QByteArray cause;
+    if (deco->d->repaintStatistics) {
+        cause = Decoration::Private::updateCause(sender(), senderSignalIndex());
+    }
+    deco->d->requestUpdate(rect.isNull() ? geometry().toRect() : rect.toRect(), cause, this);
+}
+
+DecorationRepaintStatistics DecorationButton::repaintStatistics() const
+{
+    return decoration()->d->buttonRepaintStatistics.value(this);
 }
 
 void DecorationButton::update()
@@ -384,6 +524,21 @@ bool DecorationButton::isPressed() const
     return d->isPressed();
 }
 
+bool DecorationButton::isPaintCacheEnabled() const
+{
+    return d->paintCacheEnabled;
+}
+
+void DecorationButton::setPaintCacheEnabled(bool enabled)
+{
+    d->setPaintCacheEnabled(enabled);
+}
+
+void DecorationButton::invalidatePaintCache()
+{
+    d->invalidatePaintCache();
+}
+
 #define DELEGATE(name, variableName, type) \
 type DecorationButton::name() const \
 { \
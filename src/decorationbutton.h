@@ -8,6 +8,7 @@
 
 #include <kdecoration2/kdecoration2_export.h>
 #include "decorationdefines.h"
+#include "decorationrepaintstatistics.h"
 
 #include <QObject>
 #include <QPointer>
@@ -120,6 +121,32 @@ public:
 
     QPointer<Decoration> decoration() const;
 
+    /**
+     * Whether the rendering of this DecorationButton gets cached when it is painted through
+     * DecorationButtonGroup::paint. By default this is @c false.
+     *
+     * If enabled the result of paint is stored per combination of the hovered, pressed, checked
+     * and enabled state, the active state of the DecoratedClient and the device pixel ratio and
+     * reused as long as the size of the DecorationButton, the palette and icon of the
+     * DecoratedClient and the font and spacings of the DecorationSettings do not change and the
+     * DecorationSettings do not get reconfigured. Thus it must only be enabled if paint does
+     * not depend on any other state (e.g. animations) and stays inside the geometry. Otherwise
+     * invalidatePaintCache needs to be invoked whenever such state changes.
+     * @see invalidatePaintCache
+     * @since 5.21
+     **/
+    bool isPaintCacheEnabled() const;
+    void setPaintCacheEnabled(bool enabled);
+
+    /**
+     * The repaint requests issued through update since the repaint statistics of the
+     * Decoration got enabled or last reset. Default constructed statistics if the
+     * Decoration does not collect repaint statistics.
+     * @see Decoration::setRepaintStatisticsEnabled
+     * @since 5.21
+     **/
+    DecorationRepaintStatistics repaintStatistics() const;
+
     bool event(QEvent *event) override;
 
 public Q_SLOTS:
@@ -142,6 +169,12 @@ public Q_SLOTS:
      * Overloaded method for convenience.
      **/
     void update();
+    /**
+     * Discards the cached renderings of this DecorationButton.
+     * @see isPaintCacheEnabled
+     * @since 5.21
+     **/
+    void invalidatePaintCache();
 
 Q_SIGNALS:
     void clicked(Qt::MouseButton);
@@ -172,6 +205,7 @@ protected:
     virtual void wheelEvent(QWheelEvent *event);
 
 private:
+    friend class DecorationButtonGroup;
     class Private;
     QScopedPointer<Private> d;
 };
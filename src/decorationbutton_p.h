@@ -8,7 +8,11 @@
 
 #include "decorationbutton.h"
 
-class QElapsedTimer;
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImage>
+#include <QVector>
+
 class QTimer;
 
 //
@@ -54,6 +58,10 @@ public:
 
     QString typeToString(DecorationButtonType type);
 
+    void setPaintCacheEnabled(bool enabled);
+    void invalidatePaintCache();
+    void paintCached(QPainter *painter, const QRect &repaintArea);
+
     QPointer<Decoration> decoration;
     DecorationButtonType type;
     QRectF geometry;
@@ -65,13 +73,18 @@ public:
     Qt::MouseButtons acceptedButtons;
     bool doubleClickEnabled;
     bool pressAndHold;
+    bool paintCacheEnabled = false;
 
 private:
     void init();
+    quint64 paintCacheKey(qreal devicePixelRatio) const;
     DecorationButton *q;
     Qt::MouseButtons m_pressed;
-    QScopedPointer<QElapsedTimer> m_doubleClickTimer;
+    QElapsedTimer m_doubleClickTimer;
     QScopedPointer<QTimer> m_pressAndHoldTimer;
+    QHash<quint64, QImage> m_paintCache;
+    QSizeF m_paintCacheSize;
+    QVector<QMetaObject::Connection> m_paintCacheConnections;
 };
 
 }
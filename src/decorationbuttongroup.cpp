@@ -5,14 +5,26 @@
  */
 #include "decorationbuttongroup.h"
 #include "decorationbuttongroup_p.h"
+#include "decorationbutton_p.h"
 #include "decoration.h"
 #include "decorationsettings.h"
 
 #include <QDebug>
+#include <QLoggingCategory>
+
+#include <algorithm>
 
 namespace KDecoration2
 {
 
+Q_LOGGING_CATEGORY(KDECORATION2_LAYOUT, "kdecoration.layout", QtWarningMsg)
+
+namespace {
+// bound for the follow-up layout passes in case buttons keep changing their size in
+// response to being positioned
+const int s_maxLayoutPasses = 8;
+}
+
 DecorationButtonGroup::Private::Private(Decoration *decoration, DecorationButtonGroup *parent)
     : decoration(decoration)
     , spacing(0.0)
@@ -31,22 +43,40 @@ void DecorationButtonGroup::Private::setGeometry(const QRectF &geo)
     emit q->geometryChanged(geometry);
 }
 
-namespace {
-static bool s_layoutRecursion = false;
-}
-
 void DecorationButtonGroup::Private::updateLayout()
 {
-    if (s_layoutRecursion) {
+    if (transactionDepth > 0) {
+        layoutPending = true;
+        return;
+    }
+    if (layoutInProgress) {
+        // a change caused by the current layout pass, e.g. a button adjusting its size,
+        // gets handled by a follow-up pass
+        relayoutRequested = true;
         return;
     }
-    s_layoutRecursion = true;
+    layoutInProgress = true;
+    int passes = 0;
+    do {
+        relayoutRequested = false;
+        doLayout();
+    } while (relayoutRequested && ++passes < s_maxLayoutPasses);
+    if (relayoutRequested) {
+        qCWarning(KDECORATION2_LAYOUT) << "Buttons of" << q << "still changed after"
+                                       << s_maxLayoutPasses << "layout passes, giving up";
+    }
+    relayoutRequested = false;
+    layoutInProgress = false;
+}
+
+void DecorationButtonGroup::Private::doLayout()
+{
     const QPointF &pos = geometry.topLeft();
     // first calculate new size
     qreal height = 0;
     qreal width = 0;
     for (auto it = buttons.constBegin(); it != buttons.constEnd(); ++it) {
-        if (!(*it)->isVisible()) {
+        if (it->isNull() || !(*it)->isVisible()) {
             continue;
         }
         height = qMax(height, qreal((*it)->size().height()));
@@ -61,15 +91,32 @@ void DecorationButtonGroup::Private::updateLayout()
     qreal position = pos.x();
     const auto &constButtons = buttons;
     for (auto button: constButtons) {
-        if (!button->isVisible()) {
+        if (button.isNull() || !button->isVisible()) {
             continue;
         }
         const QSizeF size = button->size();
         // TODO: center
-        button->setGeometry(QRectF(QPointF(position, pos.y()), size));
+        positionedButton = button.data();
+        positionedGeometry = QRectF(QPointF(position, pos.y()), size);
+        button->setGeometry(positionedGeometry);
         position += size.width() + spacing;
     }
-    s_layoutRecursion = false;
+    positionedButton = nullptr;
+}
+
+void DecorationButtonGroup::Private::connectButton(DecorationButton *button)
+{
+    QObject::connect(button, &DecorationButton::visibilityChanged, q, [this]() { updateLayout(); });
+    QObject::connect(button, &DecorationButton::geometryChanged, q, [this, button]() { buttonGeometryChanged(button); });
+}
+
+void DecorationButtonGroup::Private::buttonGeometryChanged(DecorationButton *button)
+{
+    if (button == positionedButton && button->geometry() == positionedGeometry) {
+        // emitted by positioning the button in doLayout
+        return;
+    }
+    updateLayout();
 }
 
 DecorationButtonGroup::DecorationButtonGroup(Decoration *parent)
@@ -84,24 +131,44 @@ DecorationButtonGroup::DecorationButtonGroup(DecorationButtonGroup::Position typ
 {
     auto settings = parent->settings();
     auto createButtons = [=] {
-        const auto &buttons = (type == Position::Left) ?
-            settings->decorationButtonsLeft() :
-            settings->decorationButtonsRight();
-        for (DecorationButtonType type : buttons) {
-            if (DecorationButton *b = buttonCreator(type, parent, this)) {
-                addButton(QPointer<DecorationButton>(b));
+        const DecorationSettingsSnapshot &snapshot = settings->snapshot();
+        const quint64 generation = (type == Position::Left) ?
+            snapshot.decorationButtonsLeftGeneration() :
+            snapshot.decorationButtonsRightGeneration();
+        if (d->buttonsGeneration == generation) {
+            // the button list did not change
+            return;
+        }
+        d->buttonsGeneration = generation;
+        LayoutTransaction transaction(this);
+        const auto &types = (type == Position::Left) ?
+            snapshot.decorationButtonsLeft() :
+            snapshot.decorationButtonsRight();
+        // keep the existing buttons of the types still present and only create the missing ones
+        QVector<QPointer<DecorationButton>> unused = d->buttons;
+        QVector<QPointer<DecorationButton>> buttons;
+        buttons.reserve(types.size());
+        for (DecorationButtonType buttonType : types) {
+            auto it = std::find_if(unused.begin(), unused.end(),
+                [buttonType](const QPointer<DecorationButton> &button) {
+                    return !button.isNull() && button->type() == buttonType;
+                }
+            );
+            if (it != unused.end()) {
+                buttons.append(*it);
+                unused.erase(it);
+            } else if (DecorationButton *b = buttonCreator(buttonType, parent, this)) {
+                d->connectButton(b);
+                buttons.append(QPointer<DecorationButton>(b));
             }
         }
+        d->buttons = buttons;
+        qDeleteAll(unused);
+        d->updateLayout();
     };
     createButtons();
     auto changed = type == Position::Left ? &DecorationSettings::decorationButtonsLeftChanged : &DecorationSettings::decorationButtonsRightChanged;
-    connect(settings.data(), changed, this,
-        [this, createButtons] {
-            qDeleteAll(d->buttons);
-            d->buttons.clear();
-            createButtons();
-        }
-    );
+    connect(settings.data(), changed, this, createButtons);
 }
 
 DecorationButtonGroup::~DecorationButtonGroup() = default;
@@ -118,10 +185,9 @@ QRectF DecorationButtonGroup::geometry() const
 
 bool DecorationButtonGroup::hasButton(DecorationButtonType type) const
 {
-    // TODO: check for deletion of button
     auto it = std::find_if(d->buttons.begin(), d->buttons.end(),
         [type](const QPointer<DecorationButton> &button) {
-            return button->type() == type;
+            return !button.isNull() && button->type() == type;
         }
     );
     return it != d->buttons.end();
@@ -159,8 +225,7 @@ void DecorationButtonGroup::setSpacing(qreal spacing)
 void DecorationButtonGroup::addButton(const QPointer<DecorationButton> &button)
 {
     Q_ASSERT(!button.isNull());
-    connect(button.data(), &DecorationButton::visibilityChanged, this, [this]() { d->updateLayout(); });
-    connect(button.data(), &DecorationButton::geometryChanged, this, [this]() { d->updateLayout(); });
+    d->connectButton(button.data());
     d->buttons.append(button);
     d->updateLayout();
 }
@@ -204,6 +269,23 @@ void DecorationButtonGroup::removeButton(const QPointer<DecorationButton> &butto
     }
 }
 
+void DecorationButtonGroup::beginLayoutTransaction()
+{
+    d->transactionDepth++;
+}
+
+void DecorationButtonGroup::commitLayoutTransaction()
+{
+    Q_ASSERT(d->transactionDepth > 0);
+    if (d->transactionDepth == 0 || --d->transactionDepth > 0) {
+        return;
+    }
+    if (d->layoutPending) {
+        d->layoutPending = false;
+        d->updateLayout();
+    }
+}
+
 void DecorationButtonGroup::paint(QPainter *painter, const QRect &repaintArea)
 {
     const auto &buttons = d->buttons;
@@ -211,7 +293,7 @@ void DecorationButtonGroup::paint(QPainter *painter, const QRect &repaintArea)
         if (!button->isVisible()) {
             continue;
         }
-        button->paint(painter, repaintArea);
+        button->d->paintCached(painter, repaintArea);
     }
 }
 
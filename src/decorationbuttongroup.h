@@ -102,6 +102,57 @@ public:
      **/
     QVector<QPointer<DecorationButton>> buttons() const;
 
+    /**
+     * Starts a layout transaction. Until the matching commitLayoutTransaction all changes
+     * which require a re-layout of the DecorationButtons, like adding, removing, hiding or
+     * resizing DecorationButtons, are only recorded. The layout is updated once when the
+     * outermost transaction gets committed. Transactions can be nested.
+     *
+     * @see commitLayoutTransaction
+     * @see LayoutTransaction
+     * @since 5.21
+     **/
+    void beginLayoutTransaction();
+    /**
+     * Ends the layout transaction started with beginLayoutTransaction. If this ends the
+     * outermost transaction and a re-layout was requested during the transaction, the
+     * layout of all DecorationButtons is updated.
+     *
+     * @see beginLayoutTransaction
+     * @since 5.21
+     **/
+    void commitLayoutTransaction();
+
+    /**
+     * Scope guard for a layout transaction on a DecorationButtonGroup.
+     *
+     * @code
+     * {
+     *     DecorationButtonGroup::LayoutTransaction transaction(group);
+     *     group->addButton(button1);
+     *     group->addButton(button2);
+     * } // layout gets updated once
+     * @endcode
+     * @since 5.21
+     **/
+    class LayoutTransaction
+    {
+    public:
+        explicit LayoutTransaction(DecorationButtonGroup *group)
+            : m_group(group)
+        {
+            m_group->beginLayoutTransaction();
+        }
+        ~LayoutTransaction()
+        {
+            m_group->commitLayoutTransaction();
+        }
+
+    private:
+        Q_DISABLE_COPY(LayoutTransaction)
+        DecorationButtonGroup *m_group;
+    };
+
 Q_SIGNALS:
     void spacingChanged(qreal);
     void geometryChanged(const QRectF&);
@@ -10,6 +10,8 @@
 #include <QRectF>
 #include <QVector>
 
+#include <limits>
+
 //
 //  W A R N I N G
 //  -------------
@@ -34,13 +36,31 @@ public:
 
     void setGeometry(const QRectF &geometry);
     void updateLayout();
+    void connectButton(DecorationButton *button);
+    void buttonGeometryChanged(DecorationButton *button);
 
     Decoration *decoration;
     QRectF geometry;
     QVector<QPointer<DecorationButton>> buttons;
     qreal spacing;
+    // generation of the settings' button list the buttons were created for,
+    // the initial value is never used by the settings
+    quint64 buttonsGeneration = std::numeric_limits<quint64>::max();
+    // nesting depth of layout transactions
+    int transactionDepth = 0;
+    // whether a layout was requested during the transaction
+    bool layoutPending = false;
+    // whether updateLayout is currently positioning the buttons of this group
+    bool layoutInProgress = false;
+    // whether a change during the current layout pass requires another pass
+    bool relayoutRequested = false;
 
 private:
+    void doLayout();
+
+    // the button and geometry doLayout is currently setting
+    DecorationButton *positionedButton = nullptr;
+    QRectF positionedGeometry;
     DecorationButtonGroup *q;
 };
 
@@ -0,0 +1,172 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationoffscreenrenderer.h"
+#include "decoratedclient.h"
+#include "decoration.h"
+#include "decorationsettings.h"
+#include "private/decoratedclientprivate.h"
+#include "private/decorationsettingsprivate.h"
+
+#include <QPainter>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QtMath>
+
+#include <atomic>
+
+namespace KDecoration2
+{
+
+namespace {
+// shared with the jobs on the thread pool, which might only start after render returned
+struct RenderBatch
+{
+    QVector<Decoration*> decorations;
+    QVector<QVector<DecorationOffscreenRenderer::Part>*> parts;
+    std::atomic<int> next{0};
+    QSemaphore finished;
+};
+}
+
+class Q_DECL_HIDDEN DecorationOffscreenRenderer::Private
+{
+public:
+    explicit Private(QThreadPool *threadPool);
+    QVector<Part> createParts(Decoration *decoration, qreal devicePixelRatio) const;
+    /**
+     * Whether the getters of the DecoratedClient and the DecorationSettings of @p decoration
+     * only read cached values, so that it can be painted on another thread.
+     **/
+    static bool isStateCached(Decoration *decoration);
+    static void renderParts(Decoration *decoration, QVector<Part> &parts);
+    /**
+     * Renders Decorations of @p batch till none is left.
+     **/
+    static void renderBatch(RenderBatch &batch);
+
+    QThreadPool *threadPool;
+};
+
+DecorationOffscreenRenderer::Private::Private(QThreadPool *threadPool)
+    : threadPool(threadPool ? threadPool : QThreadPool::globalInstance())
+{
+}
+
+QVector<DecorationOffscreenRenderer::Part> DecorationOffscreenRenderer::Private::createParts(Decoration *decoration, qreal devicePixelRatio) const
+{
+    QVector<Part> parts;
+    parts.reserve(4);
+    for (Qt::Edge edge : {Qt::TopEdge, Qt::LeftEdge, Qt::RightEdge, Qt::BottomEdge}) {
+        Part part{edge, decoration->framePartGeometry(edge), QImage()};
+        if (part.geometry.isEmpty()) {
+            continue;
+        }
+        part.image = QImage(qCeil(part.geometry.width() * devicePixelRatio),
+                            qCeil(part.geometry.height() * devicePixelRatio),
+                            QImage::Format_ARGB32_Premultiplied);
+        part.image.setDevicePixelRatio(devicePixelRatio);
+        part.image.fill(Qt::transparent);
+        parts << part;
+    }
+    return parts;
+}
+
+bool DecorationOffscreenRenderer::Private::isStateCached(Decoration *decoration)
+{
+    const auto client = decoration->client().toStrongRef();
+    if (!client || !client->d->isStateCacheEnabled() || !client->d->isColorCacheEnabled()) {
+        return false;
+    }
+    const auto settings = decoration->settings();
+    return settings && settings->d->isSettingsCacheEnabled();
+}
+
+void DecorationOffscreenRenderer::Private::renderParts(Decoration *decoration, QVector<Part> &parts)
+{
+    for (Part &part : parts) {
+        QPainter painter(&part.image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.translate(-part.geometry.topLeft());
+        painter.setClipRect(part.geometry);
+        decoration->paint(&painter, part.geometry);
+    }
+}
+
+void DecorationOffscreenRenderer::Private::renderBatch(RenderBatch &batch)
+{
+    const int count = batch.decorations.size();
+    for (int i = batch.next.fetch_add(1); i < count; i = batch.next.fetch_add(1)) {
+        renderParts(batch.decorations.at(i), *batch.parts.at(i));
+        batch.finished.release();
+    }
+}
+
+DecorationOffscreenRenderer::DecorationOffscreenRenderer(QThreadPool *threadPool)
+    : d(new Private(threadPool))
+{
+}
+
+DecorationOffscreenRenderer::~DecorationOffscreenRenderer() = default;
+
+QVector<DecorationOffscreenRenderer::Result> DecorationOffscreenRenderer::render(const QVector<Decoration*> &decorations, qreal devicePixelRatio)
+{
+    QVector<Result> results;
+    results.reserve(decorations.size());
+    for (Decoration *decoration : decorations) {
+        Result result;
+        result.decoration = decoration;
+        if (decoration) {
+            Q_ASSERT(decoration->thread() == QThread::currentThread());
+            result.parts = d->createParts(decoration, devicePixelRatio);
+        }
+        results << result;
+    }
+
+    auto batch = QSharedPointer<RenderBatch>::create();
+    // rendered by the calling thread as painting them calls into the bridge
+    QVector<int> local;
+    for (int i = 0; i < results.size(); ++i) {
+        if (results.at(i).parts.isEmpty()) {
+            continue;
+        }
+        Decoration *decoration = decorations.at(i);
+        if (!Private::isStateCached(decoration)) {
+            local << i;
+            continue;
+        }
+        // the color caches are filled lazily, fill them here so that paint neither writes
+        // to them nor calls into the bridge
+        decoration->client().toStrongRef()->d->fillColorCache();
+        batch->decorations << decoration;
+        batch->parts << &results[i].parts;
+    }
+    const int jobs = batch->decorations.size();
+
+    // the calling thread renders as well, so that render finishes even if no thread of the
+    // pool becomes available, e.g. if render is called from a job of the same pool
+    const int helpers = qMin(d->threadPool->maxThreadCount(), jobs) - 1;
+    for (int i = 0; i < helpers; ++i) {
+        d->threadPool->start(QRunnable::create(
+            [batch] {
+                Private::renderBatch(*batch);
+            }
+        ));
+    }
+    for (int i : local) {
+        Private::renderParts(decorations.at(i), results[i].parts);
+    }
+    if (jobs == 0) {
+        return results;
+    }
+    Private::renderBatch(*batch);
+    batch->finished.acquire(jobs);
+    return results;
+}
+
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_OFFSCREEN_RENDERER_H
+#define KDECORATION2_DECORATION_OFFSCREEN_RENDERER_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QImage>
+#include <QPointer>
+#include <QRect>
+#include <QScopedPointer>
+#include <QVector>
+
+class QThreadPool;
+
+namespace KDecoration2
+{
+
+class Decoration;
+
+/**
+ * @brief Renders Decorations into QImages using worker threads.
+ *
+ * The DecorationOffscreenRenderer renders a batch of Decorations, e.g. all Decorations after
+ * a change of the theme or the scale factor, into QImages. Each Decoration is split into the
+ * parts of its frame: the top part containing the title bar and the left, right and bottom
+ * borders. The client area is not rendered. The parts of one Decoration are rendered one after
+ * another on one worker thread, different Decorations are rendered in parallel.
+ *
+ * render has to be called from the thread the Decorations live in, usually the GUI thread.
+ * It takes the geometries of the parts and fills the color caches of the DecoratedClients on
+ * that thread and blocks it till all Decorations are rendered. No other code runs on the
+ * thread of the Decorations meanwhile, so their state cannot change during rendering. The
+ * calling thread renders as well, thus render also finishes if all threads of the pool are
+ * busy, for example if it is called from a job of the same pool.
+ *
+ * Decoration::paint gets invoked from worker threads. The parts of one Decoration are
+ * painted on one thread. The state read by paint must either belong to the Decoration or be
+ * immutable during rendering. The getters of DecoratedClient and DecorationSettings only
+ * read cached values if the bridge enabled the state, color and settings caches. Decorations
+ * of a bridge without these caches are therefore always painted on the calling thread. This
+ * is only safe if the paint implementation does not rely on being called from the GUI
+ * thread, for example by using QPixmap, and if the Decorations do not share mutable state
+ * without synchronization. If this cannot be guaranteed use a QThreadPool with a maximum
+ * thread count of @c 1, then the calling thread renders all Decorations itself.
+ *
+ * @code
+ * DecorationOffscreenRenderer renderer;
+ * const auto results = renderer.render(decorations, screen->devicePixelRatio());
+ * for (const auto &result : results) {
+ *     for (const auto &part : result.parts) {
+ *         uploadPart(result.decoration, part.edge, part.geometry, part.image);
+ *     }
+ * }
+ * @endcode
+ *
+ * @since 5.21
+ **/
+class KDECORATIONS2_EXPORT DecorationOffscreenRenderer
+{
+public:
+    /**
+     * One rendered part of the frame of a Decoration.
+     **/
+    struct Part {
+        /**
+         * The side of the frame, Qt::TopEdge is the part containing the title bar.
+         **/
+        Qt::Edge edge;
+        /**
+         * The geometry of the part in Decoration coordinates.
+         **/
+        QRect geometry;
+        /**
+         * The rendered part. Its device pixel ratio is the one passed to render.
+         **/
+        QImage image;
+    };
+    struct Result {
+        QPointer<Decoration> decoration;
+        /**
+         * The rendered parts, parts without a size are omitted.
+         **/
+        QVector<Part> parts;
+    };
+
+    /**
+     * Creates a DecorationOffscreenRenderer rendering on the threads of @p threadPool.
+     * If @p threadPool is @c null QThreadPool::globalInstance is used.
+     **/
+    explicit DecorationOffscreenRenderer(QThreadPool *threadPool = nullptr);
+    ~DecorationOffscreenRenderer();
+
+    /**
+     * Renders the frames of all @p decorations and returns the results in the order of
+     * @p decorations. Blocks till all Decorations are rendered. Must be called from the
+     * thread of @p decorations.
+     **/
+    QVector<Result> render(const QVector<Decoration*> &decorations, qreal devicePixelRatio = 1.0);
+
+private:
+    Q_DISABLE_COPY(DecorationOffscreenRenderer)
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+}
+
+#endif
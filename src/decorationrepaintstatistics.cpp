@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationrepaintstatistics.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+namespace KDecoration2
+{
+
+QDebug operator<<(QDebug debug, const DecorationRepaintStatistics &statistics)
+{
+    QDebugStateSaver saver(debug);
+    debug.nospace() << "DecorationRepaintStatistics("
+                    << "updates=" << statistics.updateRequests
+                    << ", dropped=" << statistics.droppedRequests
+                    << ", requestedArea=" << statistics.requestedArea
+                    << ", coalesced=" << statistics.coalescedRequests
+                    << ", flushes=" << statistics.flushes
+                    << ", flushedRects=" << statistics.flushedRects
+                    << ", flushedArea=" << statistics.flushedArea;
+    if (!statistics.flushedAreaHistogram.isEmpty()) {
+        debug << ", histogram=[";
+        for (int i = 0; i < statistics.flushedAreaHistogram.count(); ++i) {
+            if (i != 0) {
+                debug << ' ';
+            }
+            debug << statistics.flushedAreaHistogram.at(i);
+        }
+        debug << ']';
+    }
+    if (!statistics.causes.isEmpty()) {
+        // most frequent causes first
+        QVector<QPair<QByteArray, quint64>> causes;
+        causes.reserve(statistics.causes.count());
+        for (auto it = statistics.causes.constBegin(); it != statistics.causes.constEnd(); ++it) {
+            causes << qMakePair(it.key(), it.value());
+        }
+        std::sort(causes.begin(), causes.end(),
+            [](const QPair<QByteArray, quint64> &a, const QPair<QByteArray, quint64> &b) {
+                return a.second > b.second || (a.second == b.second && a.first < b.first);
+            }
+        );
+        debug << ", causes={";
+        for (int i = 0; i < causes.count(); ++i) {
+            if (i != 0) {
+                debug << ", ";
+            }
+            debug << causes.at(i).first.constData() << ": " << causes.at(i).second;
+        }
+        debug << '}';
+    }
+    debug << ')';
+    return debug;
+}
+
+}
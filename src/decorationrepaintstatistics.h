@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_REPAINT_STATISTICS_H
+#define KDECORATION2_DECORATION_REPAINT_STATISTICS_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+class QDebug;
+
+namespace KDecoration2
+{
+
+/**
+ * @brief Counters describing the repaint requests of a Decoration or DecorationButton.
+ *
+ * The statistics are only collected after enabling them through
+ * Decoration::setRepaintStatisticsEnabled or by enabling debug output for the logging
+ * category @c kdecoration.repaint, e.g. through
+ * @c QT_LOGGING_RULES="kdecoration.repaint.debug=true". In the latter case the statistics of
+ * each Decoration and its buttons are written to that category when the Decoration gets
+ * destroyed.
+ *
+ * The counters of a DecorationButton only cover the requests made through
+ * DecorationButton::update, the flush related counters stay at @c 0 for a button.
+ *
+ * @see Decoration::repaintStatistics
+ * @see DecorationButton::repaintStatistics
+ * @since 5.21
+ **/
+struct DecorationRepaintStatistics
+{
+    /**
+     * Number of invocations of update.
+     **/
+    quint64 updateRequests = 0;
+    /**
+     * Number of update requests which did not touch the frame and got dropped.
+     **/
+    quint64 droppedRequests = 0;
+    /**
+     * Sum of the areas requested by update after clipping to the frame, in logical pixels.
+     **/
+    quint64 requestedArea = 0;
+    /**
+     * Number of update requests merged into damage which was already waiting to be
+     * handed to the framework.
+     **/
+    quint64 coalescedRequests = 0;
+    /**
+     * Number of times collected damage was handed to the framework.
+     **/
+    quint64 flushes = 0;
+    /**
+     * Number of rects handed to the framework.
+     **/
+    quint64 flushedRects = 0;
+    /**
+     * Sum of the areas of the rects handed to the framework, in logical pixels.
+     **/
+    quint64 flushedArea = 0;
+    /**
+     * Histogram of the areas of the rects handed to the framework. The entry at index @c n
+     * counts the rects with an area of at least 2^n and less than 2^(n+1) pixels.
+     **/
+    QVector<quint64> flushedAreaHistogram;
+    /**
+     * Number of update requests per cause. The cause is the name of the signal which
+     * triggered the request, e.g. @c hoveredChanged or @c bordersChanged, or @c update
+     * if update was called directly.
+     **/
+    QHash<QByteArray, quint64> causes;
+};
+
+KDECORATIONS2_EXPORT QDebug operator<<(QDebug debug, const DecorationRepaintStatistics &statistics);
+
+}
+
+#endif
@@ -16,8 +16,9 @@ DecorationSettings::DecorationSettings(DecorationBridge *bridge, QObject *parent
     : QObject(parent)
     , d(std::move(bridge->settings(this)))
 {
+    DecorationSettingsSnapshot &snapshot = d->snapshot();
     auto updateUnits = [this] {
-        int gridUnit = QFontMetrics(font()).boundingRect(QLatin1Char('M')).height();;
+        int gridUnit = QFontMetrics(d->snapshot().font()).boundingRect(QLatin1Char('M')).height();;
         if (gridUnit % 2 != 0) {
             gridUnit++;
         }
@@ -31,8 +32,42 @@ DecorationSettings::DecorationSettings(DecorationBridge *bridge, QObject *parent
             emit spacingChanged();
         }
     };
-    updateUnits();
-    connect(this, &DecorationSettings::fontChanged, this, updateUnits);
+    auto updateFont = [this, updateUnits] {
+        DecorationSettingsSnapshot &snapshot = d->snapshot();
+        snapshot.m_font = d->font();
+        snapshot.m_fontMetrics = d->fontMetrics();
+        updateUnits();
+    };
+    snapshot.m_borderSize = d->borderSize();
+    snapshot.m_decorationButtonsLeft = d->decorationButtonsLeft();
+    snapshot.m_decorationButtonsRight = d->decorationButtonsRight();
+    updateFont();
+    // the snapshot has to be updated before any other receiver of the signals gets invoked,
+    // thus these are the first connections
+    connect(this, &DecorationSettings::fontChanged, this, updateFont);
+    connect(this, &DecorationSettings::borderSizeChanged, this,
+        [this](BorderSize size) {
+            d->snapshot().m_borderSize = size;
+        }
+    );
+    connect(this, &DecorationSettings::decorationButtonsLeftChanged, this,
+        [this](const QVector<DecorationButtonType> &buttons) {
+            DecorationSettingsSnapshot &snapshot = d->snapshot();
+            if (snapshot.m_decorationButtonsLeft != buttons) {
+                snapshot.m_decorationButtonsLeft = buttons;
+                snapshot.m_decorationButtonsLeftGeneration++;
+            }
+        }
+    );
+    connect(this, &DecorationSettings::decorationButtonsRightChanged, this,
+        [this](const QVector<DecorationButtonType> &buttons) {
+            DecorationSettingsSnapshot &snapshot = d->snapshot();
+            if (snapshot.m_decorationButtonsRight != buttons) {
+                snapshot.m_decorationButtonsRight = buttons;
+                snapshot.m_decorationButtonsRightGeneration++;
+            }
+        }
+    );
 }
 
 DecorationSettings::~DecorationSettings() = default;
@@ -46,15 +81,41 @@ type DecorationSettings::method() const \
 DELEGATE(bool, isOnAllDesktopsAvailable)
 DELEGATE(bool, isAlphaChannelSupported)
 DELEGATE(bool, isCloseOnDoubleClickOnMenu)
-DELEGATE(QVector<DecorationButtonType>, decorationButtonsLeft)
-DELEGATE(QVector<DecorationButtonType>, decorationButtonsRight)
-DELEGATE(BorderSize, borderSize)
-DELEGATE(QFont, font)
-DELEGATE(QFontMetricsF, fontMetrics)
-DELEGATE(int, gridUnit)
-DELEGATE(int, smallSpacing)
-DELEGATE(int, largeSpacing)
 
 #undef DELEGATE
 
+#define CACHED(type, method) \
+type DecorationSettings::method() const \
+{ \
+    if (d->isSettingsCacheEnabled()) { \
+        return d->snapshot().method(); \
+    } \
+    return d->method(); \
+}
+
+CACHED(QVector<DecorationButtonType>, decorationButtonsLeft)
+CACHED(QVector<DecorationButtonType>, decorationButtonsRight)
+CACHED(BorderSize, borderSize)
+CACHED(QFont, font)
+CACHED(QFontMetricsF, fontMetrics)
+
+#undef CACHED
+
+#define SNAPSHOT(type, method) \
+type DecorationSettings::method() const \
+{ \
+    return d->snapshot().method(); \
+}
+
+SNAPSHOT(int, gridUnit)
+SNAPSHOT(int, smallSpacing)
+SNAPSHOT(int, largeSpacing)
+
+#undef SNAPSHOT
+
+const DecorationSettingsSnapshot &DecorationSettings::snapshot() const
+{
+    return d->snapshot();
+}
+
 }
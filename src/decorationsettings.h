@@ -8,6 +8,7 @@
 
 #include <kdecoration2/kdecoration2_export.h>
 #include "decorationbutton.h"
+#include "decorationsettingssnapshot.h"
 
 #include <QObject>
 #include <QFontMetricsF>
@@ -106,6 +107,18 @@ public:
     int smallSpacing() const;
     int largeSpacing() const;
 
+    /**
+     * The values of these settings needed for painting: font, fontMetrics, gridUnit,
+     * smallSpacing, largeSpacing, borderSize and the button lists. The snapshot is updated
+     * when the corresponding change signals are emitted and is the preferred way to access
+     * these values from the paint code as no objects get constructed. Values changed by the
+     * framework without a change signal are not reflected in the snapshot.
+     *
+     * The returned reference stays valid for the lifetime of the DecorationSettings.
+     * @since 5.21
+     **/
+    const DecorationSettingsSnapshot &snapshot() const;
+
 Q_SIGNALS:
     void onAllDesktopsAvailableChanged(bool);
     void alphaChannelSupportedChanged(bool);
@@ -125,6 +138,7 @@ Q_SIGNALS:
     void reconfigured();
 
 private:
+    friend class DecorationOffscreenRenderer;
     const std::unique_ptr<DecorationSettingsPrivate> d;
 };
 
@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_SETTINGS_SNAPSHOT_H
+#define KDECORATION2_DECORATION_SETTINGS_SNAPSHOT_H
+
+#include "decorationdefines.h"
+
+#include <QFont>
+#include <QFontMetricsF>
+#include <QVector>
+
+namespace KDecoration2
+{
+
+class DecorationSettings;
+class DecorationSettingsPrivate;
+
+/**
+ * @brief The values of the DecorationSettings needed for painting.
+ *
+ * The DecorationSettingsSnapshot holds the font with its precomputed font metrics, the
+ * spacing units, the border size and the button lists. It is only updated when the
+ * DecorationSettings emit the corresponding change signals. Obtain it through
+ * DecorationSettings::snapshot to access these values in the paint code without
+ * constructing new objects on each access.
+ *
+ * The snapshot is owned by the DecorationSettings and cannot be modified by users of
+ * the DecorationSettings. Copying a snapshot is cheap as all members are implicitly
+ * shared.
+ *
+ * @see DecorationSettings::snapshot
+ * @since 5.21
+ **/
+class DecorationSettingsSnapshot
+{
+public:
+    /**
+     * @see DecorationSettings::font
+     **/
+    const QFont &font() const {
+        return m_font;
+    }
+    /**
+     * @see DecorationSettings::fontMetrics
+     **/
+    const QFontMetricsF &fontMetrics() const {
+        return m_fontMetrics;
+    }
+    /**
+     * @see DecorationSettings::gridUnit
+     **/
+    int gridUnit() const {
+        return m_gridUnit;
+    }
+    /**
+     * @see DecorationSettings::smallSpacing
+     **/
+    int smallSpacing() const {
+        return m_smallSpacing;
+    }
+    /**
+     * @see DecorationSettings::largeSpacing
+     **/
+    int largeSpacing() const {
+        return m_largeSpacing;
+    }
+    /**
+     * @see DecorationSettings::borderSize
+     **/
+    BorderSize borderSize() const {
+        return m_borderSize;
+    }
+    /**
+     * @see DecorationSettings::decorationButtonsLeft
+     **/
+    const QVector<DecorationButtonType> &decorationButtonsLeft() const {
+        return m_decorationButtonsLeft;
+    }
+    /**
+     * @see DecorationSettings::decorationButtonsRight
+     **/
+    const QVector<DecorationButtonType> &decorationButtonsRight() const {
+        return m_decorationButtonsRight;
+    }
+    /**
+     * A counter incremented whenever the content of decorationButtonsLeft changes. Comparing
+     * it with a previously seen value tells whether the list needs to be looked at again.
+     **/
+    quint64 decorationButtonsLeftGeneration() const {
+        return m_decorationButtonsLeftGeneration;
+    }
+    /**
+     * A counter incremented whenever the content of decorationButtonsRight changes.
+     * @see decorationButtonsLeftGeneration
+     **/
+    quint64 decorationButtonsRightGeneration() const {
+        return m_decorationButtonsRightGeneration;
+    }
+
+private:
+    friend class DecorationSettings;
+    friend class DecorationSettingsPrivate;
+    QFont m_font;
+    QFontMetricsF m_fontMetrics = QFontMetricsF(QFont());
+    int m_gridUnit = -1;
+    int m_smallSpacing = -1;
+    int m_largeSpacing = -1;
+    BorderSize m_borderSize = BorderSize::Normal;
+    QVector<DecorationButtonType> m_decorationButtonsLeft;
+    QVector<DecorationButtonType> m_decorationButtonsRight;
+    quint64 m_decorationButtonsLeftGeneration = 0;
+    quint64 m_decorationButtonsRightGeneration = 0;
+};
+
+}
+
+#endif
@@ -6,99 +6,199 @@
 #include "decorationshadow.h"
 #include "decorationshadow_p.h"
 
+#include <QMultiHash>
+#include <QWeakPointer>
+
+#include <algorithm>
+#include <iterator>
+
 namespace KDecoration2
 {
 
+namespace {
+struct SharedShadow
+{
+    DecorationShadow *shadow;
+    QWeakPointer<DecorationShadow> reference;
+};
+
+typedef QMultiHash<uint, SharedShadow> SharedShadowHash;
+Q_GLOBAL_STATIC(SharedShadowHash, s_sharedShadows)
+
+uint sharedShadowHash(const QImage &image, const QRect &innerShadowRect, const QMargins &padding)
+{
+    const int values[] = {
+        innerShadowRect.x(), innerShadowRect.y(), innerShadowRect.width(), innerShadowRect.height(),
+        padding.left(), padding.top(), padding.right(), padding.bottom(),
+        image.width(), image.height(), int(image.format())
+    };
+    // only the pixels of each scanline, the padding at the end of the scanlines is undefined
+    const size_t lineBytes = size_t(image.width()) * image.depth() / 8;
+    uint pixels = 0;
+    for (int y = 0; y < image.height(); ++y) {
+        pixels = qHashBits(image.constScanLine(y), lineBytes, pixels);
+    }
+    return qHashRange(std::begin(values), std::end(values), pixels);
+}
+}
+
 DecorationShadow::Private::Private(DecorationShadow *parent)
     : q(parent)
 {
 }
 
-DecorationShadow::Private::~Private() = default;
-
-DecorationShadow::DecorationShadow()
-    : QObject()
-    , d(new Private(this))
+DecorationShadow::Private::~Private()
 {
+    removeFromCache();
 }
 
-DecorationShadow::~DecorationShadow() = default;
-
-QRect DecorationShadow::topLeftGeometry() const
+void DecorationShadow::Private::removeFromCache()
 {
-    if (d->innerShadowRect.isNull() || d->shadow.isNull()) {
-        return QRect();
+    if (!cached) {
+        return;
+    }
+    cached = false;
+    if (s_sharedShadows.isDestroyed()) {
+        return;
+    }
+    auto it = s_sharedShadows->find(cacheHash);
+    while (it != s_sharedShadows->end() && it.key() == cacheHash) {
+        if (it->shadow == q) {
+            it = s_sharedShadows->erase(it);
+        } else {
+            ++it;
+        }
     }
-    return QRect(0, 0, d->innerShadowRect.left(), d->innerShadowRect.top());
 }
 
-QRect DecorationShadow::topGeometry() const
+void DecorationShadow::Private::changed(bool geometryChanged)
 {
-    if (d->innerShadowRect.isNull() || d->shadow.isNull()) {
-        return QRect();
+    removeFromCache();
+    if (geometryChanged) {
+        update();
     }
-    return QRect(d->innerShadowRect.left(), 0, d->innerShadowRect.width(), d->innerShadowRect.top());
+    version++;
 }
 
-QRect DecorationShadow::topRightGeometry() const
+void DecorationShadow::Private::update()
 {
-    if (d->innerShadowRect.isNull() || d->shadow.isNull()) {
-        return QRect();
-    }
-    return QRect(d->innerShadowRect.left() + d->innerShadowRect.width(), 0,
-                 d->shadow.width() - d->innerShadowRect.width() - d->innerShadowRect.left(),
-                 d->innerShadowRect.top());
+    updateGeometries();
+    updateTiles();
 }
 
-QRect DecorationShadow::rightGeometry() const
+void DecorationShadow::Private::updateGeometries()
 {
-    if (d->innerShadowRect.isNull() || d->shadow.isNull()) {
-        return QRect();
+    if (innerShadowRect.isNull() || shadow.isNull()) {
+        std::fill(std::begin(geometries), std::end(geometries), QRect());
+        return;
     }
-    return QRect(d->innerShadowRect.left() + d->innerShadowRect.width(),
-                 d->innerShadowRect.top(),
-                 d->shadow.width() - d->innerShadowRect.width() - d->innerShadowRect.left(),
-                 d->innerShadowRect.height());
+    const int left = innerShadowRect.left();
+    const int top = innerShadowRect.top();
+    const int right = left + innerShadowRect.width();
+    const int bottom = top + innerShadowRect.height();
+    const int rightWidth = shadow.width() - right;
+    const int bottomHeight = shadow.height() - bottom;
+    geometries[0] = QRect(0, 0, left, top);
+    geometries[1] = QRect(left, 0, innerShadowRect.width(), top);
+    geometries[2] = QRect(right, 0, rightWidth, top);
+    geometries[3] = QRect(right, top, rightWidth, innerShadowRect.height());
+    geometries[4] = QRect(right, bottom, rightWidth, bottomHeight);
+    geometries[5] = QRect(left, bottom, innerShadowRect.width(), bottomHeight);
+    geometries[6] = QRect(0, bottom, left, bottomHeight);
+    geometries[7] = QRect(0, top, left, innerShadowRect.height());
 }
 
-QRect DecorationShadow::bottomRightGeometry() const
+void DecorationShadow::Private::updateTiles()
 {
-    if (d->innerShadowRect.isNull() || d->shadow.isNull()) {
-        return QRect();
+    tiles.clear();
+    // a shadow is commonly set up with setShadow followed by setInnerShadowRect, the tiles
+    // are only built once both are set
+    if (innerShadowRect.isNull() || shadow.isNull()) {
+        return;
+    }
+    tiles.reserve(8);
+    const QRect imageRect = shadow.rect();
+    for (const QRect &geometry : geometries) {
+        const QRect rect = geometry & imageRect;
+        if (rect.isEmpty()) {
+            tiles << QImage();
+            continue;
+        }
+        if (shadow.depth() % 32 != 0) {
+            // views into the image require 32 bit aligned scanlines
+            tiles << shadow.copy(rect);
+            continue;
+        }
+        // the view holds a copy of the shadow image which keeps the pixel data alive
+        QImage view(shadow.constScanLine(rect.y()) + rect.x() * (shadow.depth() / 8),
+                    rect.width(), rect.height(), shadow.bytesPerLine(), shadow.format(),
+                    [](void *info) {
+                        delete static_cast<QImage*>(info);
+                    },
+                    new QImage(shadow));
+        view.setDevicePixelRatio(shadow.devicePixelRatio());
+        tiles << view;
     }
-    return QRect(d->innerShadowRect.left() + d->innerShadowRect.width(),
-                 d->innerShadowRect.top() + d->innerShadowRect.height(),
-                 d->shadow.width() - d->innerShadowRect.width() - d->innerShadowRect.left(),
-                 d->shadow.height() - d->innerShadowRect.top() - d->innerShadowRect.height());
 }
 
-QRect DecorationShadow::bottomGeometry() const
+QSharedPointer<DecorationShadow> DecorationShadow::shared(const QImage &shadow, const QRect &innerShadowRect, const QMargins &padding)
 {
-    if (d->innerShadowRect.isNull() || d->shadow.isNull()) {
-        return QRect();
+    const uint hash = sharedShadowHash(shadow, innerShadowRect, padding);
+    for (auto it = s_sharedShadows->constFind(hash); it != s_sharedShadows->constEnd() && it.key() == hash; ++it) {
+        const QSharedPointer<DecorationShadow> candidate = it->reference.toStrongRef();
+        if (candidate &&
+                candidate->d->innerShadowRect == innerShadowRect &&
+                candidate->d->padding == padding &&
+                candidate->d->shadow == shadow) {
+            return candidate;
+        }
     }
-    return QRect(d->innerShadowRect.left(),
-                 d->innerShadowRect.top() + d->innerShadowRect.height(),
-                 d->innerShadowRect.width(),
-                 d->shadow.height() - d->innerShadowRect.top() - d->innerShadowRect.height());
+    auto decorationShadow = QSharedPointer<DecorationShadow>::create();
+    decorationShadow->d->shadow = shadow;
+    decorationShadow->d->innerShadowRect = innerShadowRect;
+    decorationShadow->d->padding = padding;
+    decorationShadow->d->update();
+    decorationShadow->d->cached = true;
+    decorationShadow->d->cacheHash = hash;
+    s_sharedShadows->insert(hash, {decorationShadow.data(), decorationShadow.toWeakRef()});
+    return decorationShadow;
 }
 
-QRect DecorationShadow::bottomLeftGeometry() const
+DecorationShadow::DecorationShadow()
+    : QObject()
+    , d(new Private(this))
 {
-    if (d->innerShadowRect.isNull() || d->shadow.isNull()) {
-        return QRect();
+}
+
+DecorationShadow::~DecorationShadow() = default;
+
+#ifndef K_DOXYGEN
+#define GEOMETRY(name, index) \
+    QRect DecorationShadow::name() const \
+    { \
+        return d->geometries[index]; \
     }
-    return QRect(0, d->innerShadowRect.top() + d->innerShadowRect.height(),
-                 d->innerShadowRect.left(),
-                 d->shadow.height() - d->innerShadowRect.top() - d->innerShadowRect.height());
+
+GEOMETRY(topLeftGeometry, 0)
+GEOMETRY(topGeometry, 1)
+GEOMETRY(topRightGeometry, 2)
+GEOMETRY(rightGeometry, 3)
+GEOMETRY(bottomRightGeometry, 4)
+GEOMETRY(bottomGeometry, 5)
+GEOMETRY(bottomLeftGeometry, 6)
+GEOMETRY(leftGeometry, 7)
+
+#undef GEOMETRY
+#endif
+
+QVector<QImage> DecorationShadow::tiles() const
+{
+    return d->tiles;
 }
 
-QRect DecorationShadow::leftGeometry() const
+quint64 DecorationShadow::version() const
 {
-    if (d->innerShadowRect.isNull() || d->shadow.isNull()) {
-        return QRect();
-    }
-    return QRect(0, d->innerShadowRect.top(), d->innerShadowRect.left(), d->innerShadowRect.height());
+    return d->version;
 }
 
 #ifndef K_DOXYGEN
@@ -133,6 +233,7 @@ I(left, Left)
             return; \
         } \
         d->name = arg; \
+        d->changed(true); \
         emit name##Changed(d->name); \
     }
 
@@ -147,6 +248,8 @@ void DecorationShadow::setPadding(const QMargins &margins)
         return;
     }
     d->padding = margins;
+    // the padding does not affect the elements
+    d->changed(false);
     emit paddingChanged();
 }
 
@@ -156,6 +259,7 @@ void DecorationShadow::setInnerShadowRect(const QRect &rect)
         return;
     }
     d->innerShadowRect = rect;
+    d->changed(true);
     emit innerShadowRectChanged();
 }
 
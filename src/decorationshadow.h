@@ -11,6 +11,8 @@
 #include <QMargins>
 #include <QObject>
 #include <QImage>
+#include <QSharedPointer>
+#include <QVector>
 
 namespace KDecoration2
 {
@@ -115,6 +117,46 @@ public:
     void setInnerShadowRect(const QRect &rect);
     void setPadding(const QMargins &margins);
 
+    /**
+     * Returns a DecorationShadow for the @p shadow image, @p innerShadowRect and @p padding.
+     *
+     * All callers passing identical values get the same DecorationShadow instance as long as
+     * any of them still holds a reference to it. That way many Decorations with the same
+     * shadow only keep one copy of the shadow image in memory. Modifying the returned
+     * DecorationShadow affects everybody sharing it and removes it from the cache.
+     *
+     * This method may only be used from the main thread.
+     * @since 5.21
+     **/
+    static QSharedPointer<DecorationShadow> shared(const QImage &shadow, const QRect &innerShadowRect, const QMargins &padding);
+
+    /**
+     * The eight elements of the shadow in the order topLeft, top, topRight, right,
+     * bottomRight, bottom, bottomLeft and left. Each element is an immutable view of the
+     * corresponding geometry in the shadow image and shares the pixel data with it, no
+     * pixels are copied. The views are computed when the shadow or innerShadowRect is set,
+     * so this method and the geometry getters only read and may be called from other threads
+     * as long as the DecorationShadow is not modified at the same time. An element without a
+     * size is a null QImage, if there is no valid shadow the returned QVector is empty.
+     *
+     * @see version
+     * @since 5.21
+     **/
+    QVector<QImage> tiles() const;
+    /**
+     * A counter incremented whenever shadowChanged, innerShadowRectChanged or paddingChanged
+     * is emitted. A backend can store the version together with the uploaded tiles and skip
+     * the upload as long as the version of this DecorationShadow did not change.
+     *
+     * The counter is per DecorationShadow and starts at the same value for each of them, so
+     * the key for uploaded tiles has to be the DecorationShadow together with its version.
+     * The version alone does not tell two DecorationShadows apart.
+     *
+     * @see tiles
+     * @since 5.21
+     **/
+    quint64 version() const;
+
 Q_SIGNALS:
     void shadowChanged(const QImage&);
     void innerShadowRectChanged();
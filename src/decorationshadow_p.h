@@ -20,6 +20,7 @@
 #include "decorationshadow.h"
 
 #include <QImage>
+#include <QVector>
 
 namespace KDecoration2
 {
@@ -29,9 +30,31 @@ class Q_DECL_HIDDEN DecorationShadow::Private
 public:
     explicit Private(DecorationShadow *parent);
     ~Private();
+    void removeFromCache();
+    /**
+     * Invoked after a value changed, @p geometryChanged tells whether the shadow image or the
+     * innerShadowRect changed and the geometries and tiles need to be recomputed.
+     **/
+    void changed(bool geometryChanged);
+    /**
+     * Recomputes geometries and tiles. They are computed whenever the shadow image or the
+     * innerShadowRect change, so that the const getters only read and can be used from render
+     * threads.
+     **/
+    void update();
+    void updateGeometries();
+    void updateTiles();
+
     QImage shadow;
     QRect innerShadowRect;
     QMargins padding;
+    quint64 version = 0;
+    // element geometries in the order of DecorationShadow::tiles
+    QRect geometries[8];
+    QVector<QImage> tiles;
+    // whether this DecorationShadow was created through DecorationShadow::shared
+    bool cached = false;
+    uint cacheHash = 0;
 
 private:
     DecorationShadow *q;
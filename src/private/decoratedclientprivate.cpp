@@ -16,8 +16,34 @@ public:
     explicit Private(DecoratedClient *client, Decoration *decoration);
     DecoratedClient *client;
     Decoration *decoration;
+    bool stateCacheEnabled = false;
+    bool colorCacheEnabled = false;
+    CachedState state;
+    int stateChangeDepth = 0;
+    uint pendingStateChanges = 0;
+    std::function<void(uint)> stateChangeCallback;
+
+    // colors returned by DecoratedClientPrivate::color, indexed by ColorGroup and ColorRole
+    QColor decorationColors[3][3];
+    quint16 decorationColorsValid = 0;
+    // colors of the palette, indexed by QPalette::ColorGroup and QPalette::ColorRole
+    QColor paletteColors[QPalette::NColorGroups][QPalette::NColorRoles];
+    quint64 paletteColorsValid = 0;
+
+    void flushStateChanges();
 };
 
+static_assert(QPalette::NColorGroups * QPalette::NColorRoles <= 64, "palette colors don't fit into the validity mask");
+
+void DecoratedClientPrivate::Private::flushStateChanges()
+{
+    const uint changes = pendingStateChanges;
+    pendingStateChanges = 0;
+    if (changes != 0 && stateChangeCallback) {
+        stateChangeCallback(changes);
+    }
+}
+
 DecoratedClientPrivate::Private::Private(DecoratedClient *client, Decoration *decoration)
     : client(client)
     , decoration(decoration)
@@ -54,6 +80,118 @@ QColor DecoratedClientPrivate::color(ColorGroup group, ColorRole role) const
     return QColor();
 }
 
+QColor DecoratedClientPrivate::cachedColor(ColorGroup group, ColorRole role) const
+{
+    const int groupIndex = int(group);
+    const int roleIndex = int(role);
+    if (!d->colorCacheEnabled || groupIndex < 0 || groupIndex >= 3 || roleIndex < 0 || roleIndex >= 3) {
+        return color(group, role);
+    }
+    const quint16 bit = 1 << (groupIndex * 3 + roleIndex);
+    if (!(d->decorationColorsValid & bit)) {
+        d->decorationColors[groupIndex][roleIndex] = color(group, role);
+        d->decorationColorsValid |= bit;
+    }
+    return d->decorationColors[groupIndex][roleIndex];
+}
+
+QColor DecoratedClientPrivate::cachedColor(QPalette::ColorGroup group, QPalette::ColorRole role) const
+{
+    if (!d->colorCacheEnabled || group < 0 || group >= QPalette::NColorGroups || role < 0 || role >= QPalette::NColorRoles) {
+        // disabled cache or e.g. QPalette::Current
+        return palette().color(group, role);
+    }
+    const quint64 bit = quint64(1) << (group * QPalette::NColorRoles + role);
+    if (!(d->paletteColorsValid & bit)) {
+        d->paletteColors[group][role] = palette().color(group, role);
+        d->paletteColorsValid |= bit;
+    }
+    return d->paletteColors[group][role];
+}
+
+void DecoratedClientPrivate::invalidateColorCache()
+{
+    d->decorationColorsValid = 0;
+    d->paletteColorsValid = 0;
+}
+
+void DecoratedClientPrivate::fillColorCache()
+{
+    if (!d->colorCacheEnabled) {
+        return;
+    }
+    for (int group = 0; group < 3; ++group) {
+        for (int role = 0; role < 3; ++role) {
+            cachedColor(ColorGroup(group), ColorRole(role));
+        }
+    }
+    const QPalette p = palette();
+    for (int group = 0; group < QPalette::NColorGroups; ++group) {
+        for (int role = 0; role < QPalette::NColorRoles; ++role) {
+            d->paletteColors[group][role] = p.color(QPalette::ColorGroup(group), QPalette::ColorRole(role));
+        }
+    }
+    d->paletteColorsValid = ~quint64(0) >> (64 - QPalette::NColorGroups * QPalette::NColorRoles);
+}
+
+bool DecoratedClientPrivate::isStateCacheEnabled() const
+{
+    return d->stateCacheEnabled;
+}
+
+void DecoratedClientPrivate::setStateCacheEnabled(bool enabled)
+{
+    d->stateCacheEnabled = enabled;
+}
+
+bool DecoratedClientPrivate::isColorCacheEnabled() const
+{
+    return d->colorCacheEnabled;
+}
+
+void DecoratedClientPrivate::setColorCacheEnabled(bool enabled)
+{
+    d->colorCacheEnabled = enabled;
+    invalidateColorCache();
+}
+
+const DecoratedClientPrivate::CachedState &DecoratedClientPrivate::cachedState() const
+{
+    return d->state;
+}
+
+DecoratedClientPrivate::CachedState &DecoratedClientPrivate::cachedState()
+{
+    return d->state;
+}
+
+void DecoratedClientPrivate::beginStateChange()
+{
+    d->stateChangeDepth++;
+}
+
+void DecoratedClientPrivate::endStateChange()
+{
+    Q_ASSERT(d->stateChangeDepth > 0);
+    if (d->stateChangeDepth == 0 || --d->stateChangeDepth > 0) {
+        return;
+    }
+    d->flushStateChanges();
+}
+
+void DecoratedClientPrivate::addStateChange(uint change)
+{
+    d->pendingStateChanges |= change;
+    if (d->stateChangeDepth == 0) {
+        d->flushStateChanges();
+    }
+}
+
+void DecoratedClientPrivate::setStateChangeCallback(const std::function<void(uint)> &callback)
+{
+    d->stateChangeCallback = callback;
+}
+
 ApplicationMenuEnabledDecoratedClientPrivate::ApplicationMenuEnabledDecoratedClientPrivate(DecoratedClient *client, Decoration *decoration)
     : DecoratedClientPrivate(client, decoration)
 {
@@ -11,6 +11,9 @@
 
 #include <QString>
 #include <QIcon>
+#include <QPalette>
+
+#include <functional>
 
 //
 //  W A R N I N G
@@ -80,9 +83,129 @@ public:
 
     virtual QColor color(ColorGroup group, ColorRole role) const;
 
+    /**
+     * Returns the result of color for @p group and @p role. If the color cache is enabled the
+     * result is cached till the next invalidateColorCache.
+     * @see setColorCacheEnabled
+     * @internal
+     **/
+    QColor cachedColor(ColorGroup group, ColorRole role) const;
+    /**
+     * Returns the color for @p group and @p role of palette. If the color cache is enabled the
+     * result is cached till the next invalidateColorCache.
+     * @see setColorCacheEnabled
+     * @internal
+     **/
+    QColor cachedColor(QPalette::ColorGroup group, QPalette::ColorRole role) const;
+    /**
+     * Drops the cached colors. DecoratedClient invokes it when the palette or the active
+     * state change.
+     * @internal
+     **/
+    void invalidateColorCache();
+    /**
+     * Fills the color caches with all colors of color and of the palette, so that cachedColor
+     * only reads till the next invalidateColorCache. Used before painting on other threads.
+     * Does nothing if the color cache is disabled.
+     * @internal
+     **/
+    void fillColorCache();
+    /**
+     * @since 5.21
+     **/
+    bool isColorCacheEnabled() const;
+
+    /**
+     * The client state as cached by DecoratedClient if the state cache is enabled.
+     * As DecoratedClient::modal is constant it is read once when the DecoratedClient is
+     * created and never refreshed.
+     * @see setStateCacheEnabled
+     * @since 5.21
+     **/
+    struct CachedState {
+        bool active = false;
+        bool onAllDesktops = false;
+        bool shaded = false;
+        bool maximized = false;
+        bool maximizedHorizontally = false;
+        bool maximizedVertically = false;
+        bool keepAbove = false;
+        bool keepBelow = false;
+        bool closeable = false;
+        bool maximizeable = false;
+        bool minimizeable = false;
+        bool providesContextHelp = false;
+        bool modal = false;
+        bool shadeable = false;
+        bool moveable = false;
+        bool resizeable = false;
+        int desktop = 0;
+        int width = 0;
+        int height = 0;
+        Qt::Edges adjacentScreenEdges;
+        QString caption;
+        QIcon icon;
+        QPalette palette;
+    };
+    /**
+     * @since 5.21
+     **/
+    bool isStateCacheEnabled() const;
+    /**
+     * @since 5.21
+     **/
+    const CachedState &cachedState() const;
+    /**
+     * @since 5.21
+     **/
+    CachedState &cachedState();
+
+    /**
+     * Starts a batch of state changes. The individual change signals are still emitted,
+     * but DecoratedClient::stateChanged is only emitted once with all changes when the
+     * outermost batch ends with endStateChange. Batches can be nested.
+     * @since 5.21
+     **/
+    void beginStateChange();
+    /**
+     * Ends the batch of state changes started with beginStateChange.
+     * @since 5.21
+     **/
+    void endStateChange();
+    /**
+     * Records the change of a property as DecoratedClient::StateChange value.
+     * @internal
+     **/
+    void addStateChange(uint change);
+    /**
+     * Installs the @p callback which gets invoked with the accumulated changes.
+     * @internal
+     **/
+    void setStateChangeCallback(const std::function<void(uint)> &callback);
+
 protected:
     explicit DecoratedClientPrivate(DecoratedClient *client, Decoration *decoration);
     DecoratedClient *client();
+    /**
+     * Enables caching the client state in DecoratedClient. With the cache enabled the getters
+     * of DecoratedClient return the values seen when the corresponding change signal got
+     * emitted the last time instead of calling into this DecoratedClientPrivate.
+     *
+     * Only enable the cache if the implementation emits the change signal for each state
+     * change. It has to be called from the constructor of the implementation.
+     * @since 5.21
+     **/
+    void setStateCacheEnabled(bool enabled);
+    /**
+     * Enables caching the colors returned by DecoratedClient::color. With the cache enabled
+     * each color is resolved through color respectively palette once and returned from the
+     * cache till DecoratedClient::paletteChanged or DecoratedClient::activeChanged get emitted.
+     *
+     * Only enable the cache if the colors depend on nothing but the palette and the active
+     * state, or if the implementation emits one of those signals whenever the colors change.
+     * @since 5.21
+     **/
+    void setColorCacheEnabled(bool enabled);
 
 private:
     class Private;
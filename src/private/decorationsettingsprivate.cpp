@@ -14,9 +14,8 @@ class Q_DECL_HIDDEN DecorationSettingsPrivate::Private
 public:
     explicit Private(DecorationSettings *settings);
     DecorationSettings *settings;
-    int gridUnit = -1;
-    int smallSpacing = -1;
-    int largeSpacing = -1;
+    DecorationSettingsSnapshot snapshot;
+    bool settingsCacheEnabled = false;
 };
 
 DecorationSettingsPrivate::Private::Private(DecorationSettings *settings)
@@ -55,32 +54,52 @@ QFontMetricsF DecorationSettingsPrivate::fontMetrics() const
 
 int DecorationSettingsPrivate::gridUnit() const
 {
-    return d->gridUnit;
+    return d->snapshot.m_gridUnit;
 }
 
 int DecorationSettingsPrivate::smallSpacing() const
 {
-    return d->smallSpacing;
+    return d->snapshot.m_smallSpacing;
 }
 
 int DecorationSettingsPrivate::largeSpacing() const
 {
-    return d->largeSpacing;
+    return d->snapshot.m_largeSpacing;
 }
 
 void DecorationSettingsPrivate::setGridUnit(int unit)
 {
-    d->gridUnit = unit;
+    d->snapshot.m_gridUnit = unit;
 }
 
 void DecorationSettingsPrivate::setLargeSpacing(int spacing)
 {
-    d->largeSpacing = spacing;
+    d->snapshot.m_largeSpacing = spacing;
 }
 
 void DecorationSettingsPrivate::setSmallSpacing(int spacing)
 {
-    d->smallSpacing = spacing;
+    d->snapshot.m_smallSpacing = spacing;
+}
+
+DecorationSettingsSnapshot &DecorationSettingsPrivate::snapshot()
+{
+    return d->snapshot;
+}
+
+const DecorationSettingsSnapshot &DecorationSettingsPrivate::snapshot() const
+{
+    return d->snapshot;
+}
+
+bool DecorationSettingsPrivate::isSettingsCacheEnabled() const
+{
+    return d->settingsCacheEnabled;
+}
+
+void DecorationSettingsPrivate::setSettingsCacheEnabled(bool enabled)
+{
+    d->settingsCacheEnabled = enabled;
 }
 
 }
@@ -8,6 +8,7 @@
 
 #include <kdecoration2/private/kdecoration2_private_export.h>
 #include "../decorationdefines.h"
+#include "../decorationsettingssnapshot.h"
 #include <QVector>
 #include <QFont>
 #include <QFontMetricsF>
@@ -51,8 +52,29 @@ public:
     void setLargeSpacing(int spacing);
     void setSmallSpacing(int spacing);
 
+    /**
+     * The snapshot of the settings maintained by DecorationSettings.
+     * @since 5.21
+     **/
+    DecorationSettingsSnapshot &snapshot();
+    const DecorationSettingsSnapshot &snapshot() const;
+    /**
+     * @since 5.21
+     **/
+    bool isSettingsCacheEnabled() const;
+
 protected:
     explicit DecorationSettingsPrivate(DecorationSettings *parent);
+    /**
+     * Enables serving the getters of DecorationSettings for the button lists, the border size,
+     * the font and the font metrics from the snapshot instead of calling into this
+     * DecorationSettingsPrivate. The snapshot only follows the change signals of
+     * DecorationSettings, thus only enable it if the implementation emits the change signal
+     * for each change of these values. It has to be called from the constructor of the
+     * implementation.
+     * @since 5.21
+     **/
+    void setSettingsCacheEnabled(bool enabled);
 
 private:
     class Private;
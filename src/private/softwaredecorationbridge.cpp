@@ -0,0 +1,479 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "softwaredecorationbridge.h"
+#include "../decoratedclient.h"
+#include "../decoration.h"
+#include "../decorationsettings.h"
+
+#include <QHash>
+#include <QIcon>
+#include <QPainter>
+#include <QPalette>
+#include <QtMath>
+
+namespace KDecoration2
+{
+
+class Q_DECL_HIDDEN SoftwareDecoratedClient::Private
+{
+public:
+    bool active = true;
+    QString caption;
+    int desktop = 1;
+    bool onAllDesktops = false;
+    bool shaded = false;
+    QIcon icon;
+    bool maximizedHorizontally = false;
+    bool maximizedVertically = false;
+    bool keepAbove = false;
+    bool keepBelow = false;
+    bool closeable = true;
+    bool maximizeable = true;
+    bool minimizeable = true;
+    bool providesContextHelp = false;
+    bool shadeable = true;
+    bool moveable = true;
+    bool resizeable = true;
+    QSize size = QSize(0, 0);
+    QPalette palette;
+    Qt::Edges adjacentScreenEdges;
+};
+
+SoftwareDecoratedClient::SoftwareDecoratedClient(DecoratedClient *client, Decoration *decoration)
+    : ApplicationMenuEnabledDecoratedClientPrivate(client, decoration)
+    , d(new Private)
+{
+    // every setter emits the change signal and the colors only depend on the palette
+    setStateCacheEnabled(true);
+    setColorCacheEnabled(true);
+}
+
+SoftwareDecoratedClient::~SoftwareDecoratedClient() = default;
+
+#define GETTER(type, method, variable) \
+type SoftwareDecoratedClient::method() const \
+{ \
+    return d->variable; \
+}
+
+GETTER(bool, isActive, active)
+GETTER(QString, caption, caption)
+GETTER(int, desktop, desktop)
+GETTER(bool, isOnAllDesktops, onAllDesktops)
+GETTER(bool, isShaded, shaded)
+GETTER(QIcon, icon, icon)
+GETTER(bool, isMaximizedHorizontally, maximizedHorizontally)
+GETTER(bool, isMaximizedVertically, maximizedVertically)
+GETTER(bool, isKeepAbove, keepAbove)
+GETTER(bool, isKeepBelow, keepBelow)
+GETTER(bool, isCloseable, closeable)
+GETTER(bool, isMaximizeable, maximizeable)
+GETTER(bool, isMinimizeable, minimizeable)
+GETTER(bool, providesContextHelp, providesContextHelp)
+GETTER(bool, isShadeable, shadeable)
+GETTER(bool, isMoveable, moveable)
+GETTER(bool, isResizeable, resizeable)
+GETTER(QSize, size, size)
+GETTER(QPalette, palette, palette)
+GETTER(Qt::Edges, adjacentScreenEdges, adjacentScreenEdges)
+
+#undef GETTER
+
+bool SoftwareDecoratedClient::isMaximized() const
+{
+    return d->maximizedHorizontally && d->maximizedVertically;
+}
+
+bool SoftwareDecoratedClient::isModal() const
+{
+    return false;
+}
+
+WId SoftwareDecoratedClient::windowId() const
+{
+    return 0;
+}
+
+WId SoftwareDecoratedClient::decorationId() const
+{
+    return 0;
+}
+
+int SoftwareDecoratedClient::width() const
+{
+    return d->size.width();
+}
+
+int SoftwareDecoratedClient::height() const
+{
+    return d->size.height();
+}
+
+bool SoftwareDecoratedClient::hasApplicationMenu() const
+{
+    return false;
+}
+
+bool SoftwareDecoratedClient::isApplicationMenuActive() const
+{
+    return false;
+}
+
+#define IGNORED(method) \
+void SoftwareDecoratedClient::method() \
+{ \
+}
+
+IGNORED(requestHideToolTip)
+IGNORED(requestClose)
+IGNORED(requestMinimize)
+IGNORED(requestContextHelp)
+IGNORED(requestShowWindowMenu)
+
+#undef IGNORED
+
+void SoftwareDecoratedClient::requestShowToolTip(const QString &text)
+{
+    Q_UNUSED(text)
+}
+
+void SoftwareDecoratedClient::requestShowApplicationMenu(const QRect &rect, int actionId)
+{
+    Q_UNUSED(rect)
+    Q_UNUSED(actionId)
+}
+
+void SoftwareDecoratedClient::showApplicationMenu(int actionId)
+{
+    Q_UNUSED(actionId)
+}
+
+void SoftwareDecoratedClient::requestToggleMaximization(Qt::MouseButtons buttons)
+{
+    // same mapping as the default window manager configuration
+    if (buttons.testFlag(Qt::MiddleButton)) {
+        setMaximized(d->maximizedHorizontally, !d->maximizedVertically);
+    } else if (buttons.testFlag(Qt::RightButton)) {
+        setMaximized(!d->maximizedHorizontally, d->maximizedVertically);
+    } else {
+        const bool maximize = !isMaximized();
+        setMaximized(maximize, maximize);
+    }
+}
+
+void SoftwareDecoratedClient::requestToggleOnAllDesktops()
+{
+    setOnAllDesktops(!d->onAllDesktops);
+}
+
+void SoftwareDecoratedClient::requestToggleShade()
+{
+    if (d->shadeable) {
+        setShaded(!d->shaded);
+    }
+}
+
+void SoftwareDecoratedClient::requestToggleKeepAbove()
+{
+    setKeepAbove(!d->keepAbove);
+}
+
+void SoftwareDecoratedClient::requestToggleKeepBelow()
+{
+    setKeepBelow(!d->keepBelow);
+}
+
+#define SETTER(type, method, variable, signal) \
+void SoftwareDecoratedClient::method(type value) \
+{ \
+    if (d->variable == value) { \
+        return; \
+    } \
+    d->variable = value; \
+    emit client()->signal(value); \
+}
+
+SETTER(bool, setActive, active, activeChanged)
+SETTER(const QString &, setCaption, caption, captionChanged)
+SETTER(int, setDesktop, desktop, desktopChanged)
+SETTER(bool, setOnAllDesktops, onAllDesktops, onAllDesktopsChanged)
+SETTER(bool, setShaded, shaded, shadedChanged)
+SETTER(bool, setKeepAbove, keepAbove, keepAboveChanged)
+SETTER(bool, setKeepBelow, keepBelow, keepBelowChanged)
+SETTER(bool, setCloseable, closeable, closeableChanged)
+SETTER(bool, setMaximizeable, maximizeable, maximizeableChanged)
+SETTER(bool, setMinimizeable, minimizeable, minimizeableChanged)
+SETTER(bool, setProvidesContextHelp, providesContextHelp, providesContextHelpChanged)
+SETTER(bool, setShadeable, shadeable, shadeableChanged)
+SETTER(bool, setMoveable, moveable, moveableChanged)
+SETTER(bool, setResizeable, resizeable, resizeableChanged)
+SETTER(const QPalette &, setPalette, palette, paletteChanged)
+SETTER(Qt::Edges, setAdjacentScreenEdges, adjacentScreenEdges, adjacentScreenEdgesChanged)
+
+#undef SETTER
+
+void SoftwareDecoratedClient::setIcon(const QIcon &icon)
+{
+    // QIcon has no comparison
+    d->icon = icon;
+    emit client()->iconChanged(icon);
+}
+
+void SoftwareDecoratedClient::setMaximized(bool horizontally, bool vertically)
+{
+    const bool wasMaximized = isMaximized();
+    beginStateChange();
+    if (d->maximizedHorizontally != horizontally) {
+        d->maximizedHorizontally = horizontally;
+        emit client()->maximizedHorizontallyChanged(horizontally);
+    }
+    if (d->maximizedVertically != vertically) {
+        d->maximizedVertically = vertically;
+        emit client()->maximizedVerticallyChanged(vertically);
+    }
+    if (wasMaximized != isMaximized()) {
+        emit client()->maximizedChanged(isMaximized());
+    }
+    endStateChange();
+}
+
+void SoftwareDecoratedClient::setSize(const QSize &size)
+{
+    if (d->size == size) {
+        return;
+    }
+    const QSize old = d->size;
+    d->size = size;
+    beginStateChange();
+    if (old.width() != size.width()) {
+        emit client()->widthChanged(size.width());
+    }
+    if (old.height() != size.height()) {
+        emit client()->heightChanged(size.height());
+    }
+    emit client()->sizeChanged(size);
+    endStateChange();
+}
+
+class Q_DECL_HIDDEN SoftwareDecorationSettings::Private
+{
+public:
+    bool onAllDesktopsAvailable = true;
+    bool alphaChannelSupported = true;
+    bool closeOnDoubleClickOnMenu = false;
+    QVector<DecorationButtonType> decorationButtonsLeft{DecorationButtonType::Menu, DecorationButtonType::OnAllDesktops};
+    QVector<DecorationButtonType> decorationButtonsRight{DecorationButtonType::Minimize, DecorationButtonType::Maximize, DecorationButtonType::Close};
+    BorderSize borderSize = BorderSize::Normal;
+};
+
+SoftwareDecorationSettings::SoftwareDecorationSettings(DecorationSettings *parent)
+    : DecorationSettingsPrivate(parent)
+    , d(new Private)
+{
+    // every setter emits the change signal
+    setSettingsCacheEnabled(true);
+}
+
+SoftwareDecorationSettings::~SoftwareDecorationSettings() = default;
+
+#define DELEGATE(type, argumentType, method, setter, variable, signal) \
+type SoftwareDecorationSettings::method() const \
+{ \
+    return d->variable; \
+} \
+void SoftwareDecorationSettings::setter(argumentType value) \
+{ \
+    if (d->variable == value) { \
+        return; \
+    } \
+    d->variable = value; \
+    emit decorationSettings()->signal(value); \
+}
+
+DELEGATE(bool, bool, isOnAllDesktopsAvailable, setOnAllDesktopsAvailable, onAllDesktopsAvailable, onAllDesktopsAvailableChanged)
+DELEGATE(bool, bool, isAlphaChannelSupported, setAlphaChannelSupported, alphaChannelSupported, alphaChannelSupportedChanged)
+DELEGATE(bool, bool, isCloseOnDoubleClickOnMenu, setCloseOnDoubleClickOnMenu, closeOnDoubleClickOnMenu, closeOnDoubleClickOnMenuChanged)
+DELEGATE(QVector<DecorationButtonType>, const QVector<DecorationButtonType> &, decorationButtonsLeft, setDecorationButtonsLeft, decorationButtonsLeft, decorationButtonsLeftChanged)
+DELEGATE(QVector<DecorationButtonType>, const QVector<DecorationButtonType> &, decorationButtonsRight, setDecorationButtonsRight, decorationButtonsRight, decorationButtonsRightChanged)
+DELEGATE(BorderSize, BorderSize, borderSize, setBorderSize, borderSize, borderSizeChanged)
+
+#undef DELEGATE
+
+class Q_DECL_HIDDEN SoftwareDecorationBridge::Private
+{
+public:
+    struct Buffer {
+        SoftwareDecoratedClient *client = nullptr;
+        QImage image;
+        QRegion damage;
+        quint64 paintCount = 0;
+        quint64 paintedArea = 0;
+    };
+    QHash<Decoration*, Buffer> buffers;
+    SoftwareDecorationSettings *settings = nullptr;
+    qreal devicePixelRatio = 1.0;
+    bool autoRender = false;
+    bool renderScheduled = false;
+};
+
+SoftwareDecorationBridge::SoftwareDecorationBridge(QObject *parent)
+    : DecorationBridge(parent)
+    , d(new Private)
+{
+}
+
+SoftwareDecorationBridge::~SoftwareDecorationBridge() = default;
+
+std::unique_ptr<DecoratedClientPrivate> SoftwareDecorationBridge::createClient(DecoratedClient *client, Decoration *decoration)
+{
+    auto ptr = std::unique_ptr<SoftwareDecoratedClient>(new SoftwareDecoratedClient(client, decoration));
+    d->buffers[decoration].client = ptr.get();
+    connect(decoration, &QObject::destroyed, this,
+        [this](QObject *o) {
+            d->buffers.remove(static_cast<Decoration*>(o));
+        }
+    );
+    return std::move(ptr);
+}
+
+std::unique_ptr<DecorationSettingsPrivate> SoftwareDecorationBridge::settings(DecorationSettings *parent)
+{
+    auto ptr = std::unique_ptr<SoftwareDecorationSettings>(new SoftwareDecorationSettings(parent));
+    SoftwareDecorationSettings *settings = ptr.get();
+    d->settings = settings;
+    connect(parent, &QObject::destroyed, this,
+        [this, settings] {
+            if (d->settings == settings) {
+                d->settings = nullptr;
+            }
+        }
+    );
+    return std::move(ptr);
+}
+
+void SoftwareDecorationBridge::update(Decoration *decoration, const QRect &geometry)
+{
+    auto it = d->buffers.find(decoration);
+    if (it == d->buffers.end()) {
+        return;
+    }
+    it->damage += geometry;
+    if (d->autoRender && !d->renderScheduled) {
+        d->renderScheduled = true;
+        QMetaObject::invokeMethod(this,
+            [this] {
+                d->renderScheduled = false;
+                render();
+            }, Qt::QueuedConnection
+        );
+    }
+}
+
+SoftwareDecoratedClient *SoftwareDecorationBridge::client(Decoration *decoration) const
+{
+    return d->buffers.value(decoration).client;
+}
+
+SoftwareDecorationSettings *SoftwareDecorationBridge::decorationSettings() const
+{
+    return d->settings;
+}
+
+qreal SoftwareDecorationBridge::devicePixelRatio() const
+{
+    return d->devicePixelRatio;
+}
+
+void SoftwareDecorationBridge::setDevicePixelRatio(qreal ratio)
+{
+    d->devicePixelRatio = ratio;
+}
+
+bool SoftwareDecorationBridge::isAutoRender() const
+{
+    return d->autoRender;
+}
+
+void SoftwareDecorationBridge::setAutoRender(bool autoRender)
+{
+    d->autoRender = autoRender;
+}
+
+QRegion SoftwareDecorationBridge::render(Decoration *decoration)
+{
+    auto it = d->buffers.find(decoration);
+    if (it == d->buffers.end()) {
+        return QRegion();
+    }
+    Private::Buffer &buffer = it.value();
+    const QSize size = decoration->size();
+    const QSize imageSize(qCeil(size.width() * d->devicePixelRatio), qCeil(size.height() * d->devicePixelRatio));
+    if (imageSize.isEmpty()) {
+        return QRegion();
+    }
+    if (buffer.image.size() != imageSize || buffer.image.devicePixelRatio() != d->devicePixelRatio) {
+        buffer.image = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+        buffer.image.setDevicePixelRatio(d->devicePixelRatio);
+        buffer.image.fill(Qt::transparent);
+        buffer.damage = decoration->rect();
+    }
+    // the client area is left transparent
+    const QRegion region = buffer.damage & decoration->frameRegion();
+    buffer.damage = QRegion();
+    if (region.isEmpty()) {
+        return region;
+    }
+
+    QPainter painter(&buffer.image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (const QRect &rect : region) {
+        painter.save();
+        painter.setClipRect(rect);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.fillRect(rect, Qt::transparent);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        decoration->paint(&painter, rect);
+        painter.restore();
+        buffer.paintCount++;
+        buffer.paintedArea += quint64(rect.width()) * quint64(rect.height());
+    }
+    painter.end();
+    emit rendered(decoration, region);
+    return region;
+}
+
+void SoftwareDecorationBridge::render()
+{
+    const auto decorations = d->buffers.keys();
+    for (Decoration *decoration : decorations) {
+        // a receiver of rendered might have destroyed it
+        if (d->buffers.contains(decoration)) {
+            render(decoration);
+        }
+    }
+}
+
+QImage SoftwareDecorationBridge::image(Decoration *decoration) const
+{
+    return d->buffers.value(decoration).image;
+}
+
+QRegion SoftwareDecorationBridge::damage(Decoration *decoration) const
+{
+    return d->buffers.value(decoration).damage;
+}
+
+quint64 SoftwareDecorationBridge::paintCount(Decoration *decoration) const
+{
+    return d->buffers.value(decoration).paintCount;
+}
+
+quint64 SoftwareDecorationBridge::paintedArea(Decoration *decoration) const
+{
+    return d->buffers.value(decoration).paintedArea;
+}
+
+}
@@ -0,0 +1,255 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_SOFTWARE_DECORATION_BRIDGE_H
+#define KDECORATION2_SOFTWARE_DECORATION_BRIDGE_H
+
+#include <kdecoration2/private/kdecoration2_softwarebridge_export.h>
+#include "decoratedclientprivate.h"
+#include "decorationbridge.h"
+#include "decorationsettingsprivate.h"
+
+#include <QImage>
+#include <QRegion>
+#include <QScopedPointer>
+
+namespace KDecoration2
+{
+
+class SoftwareDecorationBridge;
+
+/**
+ * @brief DecoratedClientPrivate of the SoftwareDecorationBridge.
+ *
+ * Holds the state of the decorated window in plain members. The setters emit the change
+ * signals of the DecoratedClient, the state cache of the DecoratedClient is enabled. The
+ * requests which change the state of the window, like requestToggleShade, are applied to
+ * the state directly, all other requests are ignored.
+ *
+ * @since 5.21
+ **/
+class KDECORATIONS_SOFTWARE_BRIDGE_EXPORT SoftwareDecoratedClient : public ApplicationMenuEnabledDecoratedClientPrivate
+{
+public:
+    explicit SoftwareDecoratedClient(DecoratedClient *client, Decoration *decoration);
+    ~SoftwareDecoratedClient() override;
+
+    bool isActive() const override;
+    QString caption() const override;
+    int desktop() const override;
+    bool isOnAllDesktops() const override;
+    bool isShaded() const override;
+    QIcon icon() const override;
+    bool isMaximized() const override;
+    bool isMaximizedHorizontally() const override;
+    bool isMaximizedVertically() const override;
+    bool isKeepAbove() const override;
+    bool isKeepBelow() const override;
+
+    bool isCloseable() const override;
+    bool isMaximizeable() const override;
+    bool isMinimizeable() const override;
+    bool providesContextHelp() const override;
+    bool isModal() const override;
+    bool isShadeable() const override;
+    bool isMoveable() const override;
+    bool isResizeable() const override;
+
+    WId windowId() const override;
+    WId decorationId() const override;
+
+    int width() const override;
+    int height() const override;
+    QSize size() const override;
+    QPalette palette() const override;
+    Qt::Edges adjacentScreenEdges() const override;
+
+    bool hasApplicationMenu() const override;
+    bool isApplicationMenuActive() const override;
+
+    void requestShowToolTip(const QString &text) override;
+    void requestHideToolTip() override;
+    void requestClose() override;
+    void requestToggleMaximization(Qt::MouseButtons buttons) override;
+    void requestMinimize() override;
+    void requestContextHelp() override;
+    void requestToggleOnAllDesktops() override;
+    void requestToggleShade() override;
+    void requestToggleKeepAbove() override;
+    void requestToggleKeepBelow() override;
+    void requestShowWindowMenu() override;
+    void requestShowApplicationMenu(const QRect &rect, int actionId) override;
+    void showApplicationMenu(int actionId) override;
+
+    void setActive(bool active);
+    void setCaption(const QString &caption);
+    void setDesktop(int desktop);
+    void setOnAllDesktops(bool onAllDesktops);
+    void setShaded(bool shaded);
+    void setIcon(const QIcon &icon);
+    /**
+     * Sets the maximized states and emits their change signals as one batch.
+     **/
+    void setMaximized(bool horizontally, bool vertically);
+    void setKeepAbove(bool keepAbove);
+    void setKeepBelow(bool keepBelow);
+    void setCloseable(bool closeable);
+    void setMaximizeable(bool maximizeable);
+    void setMinimizeable(bool minimizeable);
+    void setProvidesContextHelp(bool providesContextHelp);
+    void setShadeable(bool shadeable);
+    void setMoveable(bool moveable);
+    void setResizeable(bool resizeable);
+    /**
+     * Sets the size of the client area and emits the size change signals as one batch.
+     **/
+    void setSize(const QSize &size);
+    void setPalette(const QPalette &palette);
+    void setAdjacentScreenEdges(Qt::Edges edges);
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+/**
+ * @brief DecorationSettingsPrivate of the SoftwareDecorationBridge.
+ *
+ * Holds the settings in plain members, the setters emit the change signals of the
+ * DecorationSettings. By default the title bar has a menu and on all desktops button on
+ * the left and minimize, maximize and close buttons on the right and the border size is
+ * BorderSize::Normal.
+ *
+ * @since 5.21
+ **/
+class KDECORATIONS_SOFTWARE_BRIDGE_EXPORT SoftwareDecorationSettings : public DecorationSettingsPrivate
+{
+public:
+    explicit SoftwareDecorationSettings(DecorationSettings *parent);
+    ~SoftwareDecorationSettings() override;
+
+    bool isOnAllDesktopsAvailable() const override;
+    bool isAlphaChannelSupported() const override;
+    bool isCloseOnDoubleClickOnMenu() const override;
+    QVector<DecorationButtonType> decorationButtonsLeft() const override;
+    QVector<DecorationButtonType> decorationButtonsRight() const override;
+    BorderSize borderSize() const override;
+
+    void setOnAllDesktopsAvailable(bool available);
+    void setAlphaChannelSupported(bool supported);
+    void setCloseOnDoubleClickOnMenu(bool close);
+    void setDecorationButtonsLeft(const QVector<DecorationButtonType> &buttons);
+    void setDecorationButtonsRight(const QVector<DecorationButtonType> &buttons);
+    void setBorderSize(BorderSize size);
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+/**
+ * @brief A DecorationBridge rendering Decorations into QImages.
+ *
+ * The SoftwareDecorationBridge is a complete bridge which does not need a compositor. It
+ * keeps one QImage per Decoration of the size of the Decoration including the client area,
+ * which stays transparent. Damage passed to update is collected and painted into the image
+ * by render, either explicitly or once control returns to the event loop if autoRender is
+ * enabled. It can be used to measure the paint and damage behavior of a Decoration
+ * headlessly and as starting point for an offscreen rendering bridge.
+ *
+ * The Decorations are created with the bridge passed in the arguments:
+ * @code
+ * SoftwareDecorationBridge bridge;
+ * auto decoration = factory->create<Decoration>(&bridge, QVariantList{
+ *     QVariantMap{{QStringLiteral("bridge"), QVariant::fromValue<DecorationBridge*>(&bridge)}}});
+ * decoration->setSettings(QSharedPointer<DecorationSettings>::create(&bridge));
+ * decoration->init();
+ * bridge.client(decoration)->setSize(QSize(800, 600));
+ * bridge.render(decoration);
+ * const QImage &image = bridge.image(decoration);
+ * @endcode
+ *
+ * The SoftwareDecorationBridge is not part of the KDecoration library as it implements the
+ * classes of the private library, which do not provide a stable ABI. Using it requires linking
+ * KDecoration2::KDecorationSoftwareBridge.
+ * @since 5.21
+ **/
+class KDECORATIONS_SOFTWARE_BRIDGE_EXPORT SoftwareDecorationBridge : public DecorationBridge
+{
+    Q_OBJECT
+public:
+    explicit SoftwareDecorationBridge(QObject *parent = nullptr);
+    ~SoftwareDecorationBridge() override;
+
+    std::unique_ptr<DecoratedClientPrivate> createClient(DecoratedClient *client, Decoration *decoration) override;
+    void update(Decoration *decoration, const QRect &geometry) override;
+    std::unique_ptr<DecorationSettingsPrivate> settings(DecorationSettings *parent) override;
+
+    /**
+     * The client of @p decoration, @c null if @p decoration was not created for this bridge.
+     **/
+    SoftwareDecoratedClient *client(Decoration *decoration) const;
+    /**
+     * The settings created last through settings(DecorationSettings*), @c null if none was
+     * created yet.
+     **/
+    SoftwareDecorationSettings *decorationSettings() const;
+
+    /**
+     * The device pixel ratio of the images. Changing it recreates the images on the next render.
+     * Default is @c 1.0.
+     **/
+    qreal devicePixelRatio() const;
+    void setDevicePixelRatio(qreal ratio);
+
+    /**
+     * Whether Decorations with damage are rendered automatically once control returns to the
+     * event loop. Default is @c false.
+     **/
+    bool isAutoRender() const;
+    void setAutoRender(bool autoRender);
+
+    /**
+     * Paints the damage of @p decoration into its image. If the size of the Decoration changed
+     * the image is recreated and painted completely.
+     * @returns The painted region in Decoration coordinates.
+     **/
+    QRegion render(Decoration *decoration);
+    /**
+     * Renders all Decorations of this bridge.
+     **/
+    void render();
+
+    /**
+     * The image of @p decoration as of the last render. Null before the first render.
+     **/
+    QImage image(Decoration *decoration) const;
+    /**
+     * The damage of @p decoration which is not yet rendered.
+     **/
+    QRegion damage(Decoration *decoration) const;
+    /**
+     * The number of calls to Decoration::paint for @p decoration.
+     **/
+    quint64 paintCount(Decoration *decoration) const;
+    /**
+     * The sum of the areas passed to Decoration::paint for @p decoration in logical pixels.
+     **/
+    quint64 paintedArea(Decoration *decoration) const;
+
+Q_SIGNALS:
+    /**
+     * Emitted after @p region of @p decoration got painted into its image.
+     **/
+    void rendered(KDecoration2::Decoration *decoration, const QRegion &region);
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+}
+
+#endif